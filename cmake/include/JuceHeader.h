@@ -0,0 +1,17 @@
+#pragma once
+
+// JuceHeader.h for the CMake build. The Projucer writes its own copy into JuceLibraryCode;
+// this one gives every CMake target the same view: the modules the project uses and the
+// embedded resources. Every target that includes it links the modules listed here.
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_events/juce_events.h>
+#include <juce_graphics/juce_graphics.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "BinaryData.h"
@@ -0,0 +1,126 @@
+#include "AudioThreadGuard.h"
+
+#if DISRUPTION_AUDIO_THREAD_CHECKS
+ #include <new>
+ #include <cstdlib>
+
+ #if JUCE_LINUX || JUCE_BSD || JUCE_MAC
+  #include <dlfcn.h>
+  #include <pthread.h>
+ #endif
+#endif
+
+//==============================================================================
+namespace
+{
+    // Trivially initialised, so reading it from operator new never runs TLS init code
+    thread_local bool audioThreadActive = false;
+    std::atomic<juce::uint64> numViolations { 0 };
+}
+
+AudioThreadGuard::Scope::Scope() noexcept
+    : wasActive(audioThreadActive)
+{
+    audioThreadActive = true;
+}
+
+AudioThreadGuard::Scope::~Scope() noexcept
+{
+    audioThreadActive = wasActive;
+}
+
+bool AudioThreadGuard::isActive() noexcept
+{
+    return audioThreadActive;
+}
+
+void AudioThreadGuard::reportViolation() noexcept
+{
+    numViolations.fetch_add(1, std::memory_order_relaxed);
+
+    // Assertion logging allocates, which must not report again
+    audioThreadActive = false;
+    jassertfalse;  // Allocation or lock on the audio thread, the call stack shows where
+    audioThreadActive = true;
+}
+
+juce::uint64 AudioThreadGuard::getNumViolations() noexcept
+{
+    return numViolations.load();
+}
+
+void AudioThreadGuard::resetViolations() noexcept
+{
+    numViolations = 0;
+}
+
+//==============================================================================
+#if DISRUPTION_AUDIO_THREAD_CHECKS
+
+namespace
+{
+    void* allocateChecked(std::size_t size)
+    {
+        if (audioThreadActive)
+            AudioThreadGuard::reportViolation();
+
+        if (auto* memory = std::malloc(size > 0 ? size : 1))
+            return memory;
+
+        throw std::bad_alloc();
+    }
+
+    void* allocateChecked(std::size_t size, const std::nothrow_t&) noexcept
+    {
+        if (audioThreadActive)
+            AudioThreadGuard::reportViolation();
+
+        return std::malloc(size > 0 ? size : 1);
+    }
+
+    void freeChecked(void* memory) noexcept
+    {
+        if (memory != nullptr && audioThreadActive)
+            AudioThreadGuard::reportViolation();
+
+        std::free(memory);
+    }
+}
+
+// The aligned variants are left to the runtime, nothing in the audio path uses them
+void* operator new(std::size_t size)                                    { return allocateChecked(size); }
+void* operator new[](std::size_t size)                                  { return allocateChecked(size); }
+void* operator new(std::size_t size, const std::nothrow_t& tag) noexcept   { return allocateChecked(size, tag); }
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return allocateChecked(size, tag); }
+
+void operator delete(void* memory) noexcept                             { freeChecked(memory); }
+void operator delete[](void* memory) noexcept                           { freeChecked(memory); }
+void operator delete(void* memory, std::size_t) noexcept                { freeChecked(memory); }
+void operator delete[](void* memory, std::size_t) noexcept              { freeChecked(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept      { freeChecked(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept    { freeChecked(memory); }
+
+ #if JUCE_LINUX || JUCE_BSD || JUCE_MAC
+// Covers std::mutex and juce::CriticalSection. The real function is kept in a constant
+// initialised atomic, a guarded function static could itself take a mutex
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    using LockFunction = int (*)(pthread_mutex_t*);
+    static std::atomic<LockFunction> realLock { nullptr };
+
+    auto lock = realLock.load(std::memory_order_relaxed);
+
+    if (lock == nullptr)
+    {
+        lock = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        realLock.store(lock, std::memory_order_relaxed);
+    }
+
+    if (audioThreadActive)
+        AudioThreadGuard::reportViolation();
+
+    return lock(mutex);
+}
+ #endif
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Set to 1 in debug builds to trap allocations and mutex locks inside processBlock. The
+// checks replace the global operator new and delete and, on Linux and macOS,
+// pthread_mutex_lock for the binary they are linked into
+#ifndef DISRUPTION_AUDIO_THREAD_CHECKS
+ #define DISRUPTION_AUDIO_THREAD_CHECKS 0
+#endif
+
+//==============================================================================
+// Marks the current thread as running audio code. While a Scope is alive, every
+// allocation, deallocation and mutex lock on that thread is counted as a violation
+// and asserts.
+//
+// Blocking calls JUCE makes through malloc directly (HeapBlock) or through OS specific
+// primitives are not seen; those only happen in prepareToPlay in this plugin.
+struct AudioThreadGuard
+{
+    class Scope
+    {
+    public:
+        Scope() noexcept;
+        ~Scope() noexcept;
+
+    private:
+        bool wasActive;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    static bool isActive() noexcept;
+
+    // Called by the hooks, counts the violation and asserts with the guard lifted
+    static void reportViolation() noexcept;
+
+    static juce::uint64 getNumViolations() noexcept;
+    static void resetViolations() noexcept;
+};
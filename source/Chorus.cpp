@@ -0,0 +1,98 @@
+#include "Chorus.h"
+
+//==============================================================================
+void Chorus::prepare(double newSampleRate, int maximumBlockSize, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    samplesPerMs = static_cast<float>(sampleRate * 0.001);
+
+    // The Hermite kernel reads two samples past the read position, which must already be written
+    minimumDelaySamples = juce::jmax(3.f, minimumDelayMs * samplesPerMs);
+
+    const auto maximumDelaySamples = static_cast<int>(std::ceil((centreDelayMs + maximumModulationMs) * samplesPerMs)) + 4;
+    lineSize = static_cast<size_t>(juce::nextPowerOfTwo(maximumDelaySamples));
+    lineMask = lineSize - 1;
+    numChannels = static_cast<size_t>(newNumChannels);
+
+    arena.build([&] (DSPArena& memory)
+    {
+        delayLines = memory.allocate<float>(lineSize * numChannels);
+        depthRamp = memory.allocate<float>(static_cast<size_t>(maximumBlockSize));
+        mixRamp = memory.allocate<float>(static_cast<size_t>(maximumBlockSize));
+    });
+
+    depth.reset(sampleRate, smoothingSeconds);
+    mix.reset(sampleRate, smoothingSeconds);
+    reset();
+}
+
+void Chorus::reset() noexcept
+{
+    std::fill(delayLines.begin(), delayLines.end(), 0.f);
+    writePosition = 0;
+
+    depth.setCurrentAndTargetValue(depth.getTargetValue());
+    mix.setCurrentAndTargetValue(mix.getTargetValue());
+}
+
+void Chorus::setMix(float newMix) noexcept
+{
+    newMix = juce::jlimit(0.f, 1.f, newMix);
+
+    if (! isActive() && newMix > 0.f)
+    {
+        std::fill(delayLines.begin(), delayLines.end(), 0.f);
+        writePosition = 0;
+    }
+
+    mix.setTargetValue(newMix);
+}
+
+void Chorus::process(juce::dsp::AudioBlock<float>& block, const LFO& modulation) noexcept
+{
+    const auto numSamples = block.getNumSamples();
+    jassert(block.getNumChannels() <= numChannels && numSamples <= depthRamp.size());
+
+    for (size_t n = 0; n < numSamples; ++n)
+    {
+        depthRamp[n] = depth.getNextValue() * maximumModulationMs;
+        mixRamp[n] = mix.getNextValue();
+    }
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* channelData = block.getChannelPointer(channel);
+        const float* lfo = modulation.getValues(static_cast<int>(channel));
+        float* line = delayLines.data() + channel * lineSize;
+        size_t write = writePosition;
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            const float delay = juce::jmax(minimumDelaySamples, (centreDelayMs + depthRamp[n] * lfo[n]) * samplesPerMs);
+
+            // Adding lineSize keeps the position positive, the mask does the wrapping
+            const float readPosition = static_cast<float>(write + lineSize) - delay;
+            const auto index = static_cast<size_t>(readPosition);
+            const float t = readPosition - static_cast<float>(index);
+
+            const float xm1 = line[(index - 1) & lineMask];
+            const float x0 = line[index & lineMask];
+            const float x1 = line[(index + 1) & lineMask];
+            const float x2 = line[(index + 2) & lineMask];
+
+            // Catmull-Rom cubic Hermite
+            const float c1 = 0.5f * (x1 - xm1);
+            const float c2 = xm1 - 2.5f * x0 + 2.f * x1 - 0.5f * x2;
+            const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+            const float wet = ((c3 * t + c2) * t + c1) * t + x0;
+
+            const float dry = channelData[n];
+            line[write] = dry + feedback * wet;
+            write = (write + 1) & lineMask;
+
+            channelData[n] = dry + mixRamp[n] * (wet - dry);
+        }
+    }
+
+    writePosition = (writePosition + numSamples) & lineMask;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPArena.h"
+#include "LFO.h"
+
+//==============================================================================
+// Chorus: one modulated fractional delay with feedback per channel, mixed with the dry
+// signal.
+//
+// Every delay line is a power of two long, so wrapping the read and write positions is a
+// mask, and is read with 4 point cubic Hermite interpolation. The modulation comes from
+// an LFO the caller renders, so the processor drives it from the same tempo clock as the
+// tremolo. Depth and mix are smoothed per sample; the delay sweeps by depth *
+// maximumModulationMs around centreDelayMs, the mapping juce::dsp::Chorus uses.
+class Chorus
+{
+public:
+    Chorus() = default;
+
+    // Allocates the delay lines and ramp buffers (not realtime safe)
+    void prepare(double newSampleRate, int maximumBlockSize, int numChannels);
+
+    // Clear the delay lines and jump to the target depth and mix
+    void reset() noexcept;
+
+    void setDepth(float newDepth) noexcept { depth.setTargetValue(juce::jlimit(0.f, 1.f, newDepth)); }
+
+    // Wet proportion, 0 is dry only. Raising it from a settled 0 clears the delay lines,
+    // which are not fed while the chorus is not processed
+    void setMix(float newMix) noexcept;
+
+    void setFeedback(float newFeedback) noexcept { feedback = juce::jlimit(-0.95f, 0.95f, newFeedback); }
+
+    // False once the mix has settled at 0, process() can then be skipped
+    bool isActive() const noexcept { return mix.isSmoothing() || mix.getTargetValue() > 0.f; }
+
+    // Processes the block in place, reading one modulation value per sample and channel
+    // from the last LFO::process() call
+    void process(juce::dsp::AudioBlock<float>& block, const LFO& modulation) noexcept;
+
+    static constexpr float centreDelayMs = 3.f;
+    static constexpr float maximumModulationMs = 10.f;
+    static constexpr float minimumDelayMs = 1.f;
+    static constexpr double smoothingSeconds = 0.02;
+
+private:
+    DSPArena arena;
+    DSPArena::Array<float> delayLines;  // numChannels lines of lineSize samples, one after another
+    DSPArena::Array<float> depthRamp;   // Per sample values of the current block, shared by all channels
+    DSPArena::Array<float> mixRamp;
+
+    size_t lineSize = 0;
+    size_t lineMask = 0;
+    size_t writePosition = 0;  // Same for every channel
+    size_t numChannels = 0;
+
+    double sampleRate = 44100.0;
+    float samplesPerMs = 44.1f;
+    float minimumDelaySamples = 44.1f;
+    float feedback = 0.f;
+
+    juce::SmoothedValue<float> depth;
+    juce::SmoothedValue<float> mix;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Chorus)
+};
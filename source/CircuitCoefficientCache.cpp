@@ -0,0 +1,33 @@
+#include "CircuitCoefficientCache.h"
+
+//==============================================================================
+void CircuitCoefficientCache::build(double newSampleRate, const Components& components)
+{
+    sampleRate = newSampleRate;
+
+    // Prewarp each capacitor at the corner it forms with its fixed resistor
+    const double distortionCorner = 1.0 / (juce::MathConstants<double>::twoPi * components.R3 * components.C1);
+    const double clippingCorner = 1.0 / (juce::MathConstants<double>::twoPi * components.R5 * components.C2);
+
+    R1 = static_cast<float>(getPortResistance(components.C1, sampleRate, distortionCorner));
+    R2 = static_cast<float>(getPortResistance(components.C2, sampleRate, clippingCorner));
+    R4 = components.R4;
+    G_clipping = static_cast<float>(1.0 / components.R5 + 1.0 / R2);
+
+    conductance.resize(tableSize + 1);
+
+    for (int i = 0; i <= tableSize; ++i)
+    {
+        const double pot = static_cast<double>(i) / tableSize;
+        const double Rp = components.potMaximum * (1.0 - pot);
+        conductance[static_cast<size_t>(i)] = static_cast<float>(1.0 / (R1 + components.R3 + Rp));
+    }
+}
+
+double CircuitCoefficientCache::getPortResistance(double capacitance, double circuitSampleRate, double prewarpFrequency)
+{
+    // Keep the tangent well away from its pole for corners close to Nyquist
+    const double f0 = juce::jmin(prewarpFrequency, 0.4 * circuitSampleRate);
+    const double w0 = juce::MathConstants<double>::twoPi * f0;
+    return std::tan(0.5 * w0 / circuitSampleRate) / (w0 * capacitance);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Circuit coefficients for one circuit sample rate, precomputed so the audio thread
+// never divides when the drive knob moves.
+//
+// The capacitor port resistances use the trapezoidal rule prewarped at each stage's RC
+// corner, R = tan(pi f0 Ts) / (2 pi f0 C). The corners then sit at the same frequency
+// at every rate. Plain Ts / 2C puts the clipping stage's 15.9 kHz corner at about 12 kHz
+// when running at 44.1 kHz.
+//
+// The distortion stage conductance G = 1 / (R1 + R3 + Rp) is tabulated over the pot
+// position. Gb, Gi and Gx1 are affine in G, so one interpolated value gives all four.
+// The table has 4096 intervals, which keeps the worst relative error of G (pot near
+// full drive) at about 6e-4.
+class CircuitCoefficientCache
+{
+public:
+    struct Components
+    {
+        float C1, R3, R4;    // Distortion stage
+        float potMaximum;    // Drive pot resistance at position 0
+        float C2, R5;        // Clipping stage
+    };
+
+    struct Distortion
+    {
+        float G_distortion, Gb, Gi, Gx1;
+    };
+
+    CircuitCoefficientCache() = default;
+
+    // Rebuild for a circuit sample rate (not realtime safe)
+    void build(double newSampleRate, const Components& components);
+
+    // Grouped distortion coefficients for a drive pot position in [0, 1]
+    inline Distortion getDistortion(float pot) const noexcept
+    {
+        const float position = juce::jlimit(0.f, static_cast<float>(tableSize), pot * static_cast<float>(tableSize));
+        const auto index = static_cast<size_t>(juce::jmin(static_cast<int>(position), tableSize - 1));
+        const float fraction = position - static_cast<float>(index);
+        const float G = conductance[index] + fraction * (conductance[index + 1] - conductance[index]);
+
+        return { G, 1.f - R1 * G, 1.f + R4 * G, R1 * R4 * G };
+    }
+
+    float getR1() const noexcept { return R1; }
+    float getR2() const noexcept { return R2; }
+    float getClippingConductance() const noexcept { return G_clipping; }
+
+    bool isBuiltFor(double circuitSampleRate) const { return ! conductance.empty() && juce::exactlyEqual(sampleRate, circuitSampleRate); }
+
+    // Trapezoidal port resistance of a capacitor, prewarped to be exact at prewarpFrequency
+    static double getPortResistance(double capacitance, double circuitSampleRate, double prewarpFrequency);
+
+    static constexpr int tableSize = 4096;  // Number of intervals, the table holds tableSize + 1 points
+
+private:
+    std::vector<float> conductance;  // G_distortion at pot = index / tableSize
+
+    double sampleRate = 0.0;
+    float R1 = 1.f;
+    float R4 = 1.f;
+    float R2 = 1.f;
+    float G_clipping = 0.f;
+
+    JUCE_LEAK_DETECTOR(CircuitCoefficientCache)
+};
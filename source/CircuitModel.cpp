@@ -0,0 +1,552 @@
+#include "CircuitModel.h"
+
+//==============================================================================
+CircuitModel::CircuitModel()
+    : coefficientCache(&coefficientCaches[0]),
+      clippingTable(&clippingTables[0])
+{
+    // Valid coefficients for a default rate until prepare() picks the real one
+    setSampleRate(baseSampleRate);
+}
+
+void CircuitModel::prepare(double sampleRate, int numOrders, int newNumChannels, int maxCircuitBlockSize)
+{
+    jassert(numOrders > 0 && numOrders <= maxOrders);
+
+    baseSampleRate = sampleRate;
+
+    for (int order = numOrders; --order >= 0;)
+    {
+        coefficientCache = &coefficientCaches[static_cast<size_t>(order)];
+        clippingTable = &clippingTables[static_cast<size_t>(order)];
+        setSampleRate(sampleRate * (1 << order));
+    }
+
+    numChannels = static_cast<size_t>(newNumChannels);
+    const auto numGroups = (numChannels + lanes - 1) / lanes;
+
+    arena.build([&] (DSPArena& memory)
+    {
+        groups = memory.allocate<ChannelGroup>(numGroups);
+
+        // Lane groups run one after another, so one group's worth of frames is enough
+        interleavedFrames = memory.allocate<float>(static_cast<size_t>(maxCircuitBlockSize) * lanes);
+    });
+}
+
+void CircuitModel::setOversamplingOrder(int order)
+{
+    jassert(order >= 0 && order < maxOrders);
+
+    coefficientCache = &coefficientCaches[static_cast<size_t>(order)];
+    clippingTable = &clippingTables[static_cast<size_t>(order)];
+    setSampleRate(baseSampleRate * (1 << order));  // Already built by prepare(), so this only updates coefficients
+}
+
+void CircuitModel::setSampleRate(double circuitRate)
+{
+    circuitSampleRate = circuitRate;
+
+    if (! coefficientCache->isBuiltFor(circuitRate))
+        coefficientCache->build(circuitRate, { C1, R3, R4, potMaximum, C2, R5 });
+
+    updateRateCoefficients();
+}
+
+void CircuitModel::updateRateCoefficients()
+{
+    // Prewarped port resistances of C1 and C2 at the circuit rate
+    coefficients.R1 = coefficientCache->getR1();
+    coefficients.twoOverR1 = 2.f / coefficients.R1;
+
+    coefficients.R2 = coefficientCache->getR2();
+    coefficients.invR2 = 1.f / coefficients.R2;
+    coefficients.twoOverR2 = 2.f / coefficients.R2;
+    coefficients.G_clipping = coefficientCache->getClippingConductance();  // 1 / R5 + 1 / R2
+
+    diodeEquation = { Is, eta * Vt, coefficients.G_clipping, thr };
+
+    if (! clippingTable->isBuiltFor(coefficients.R2))
+        clippingTable->build(coefficients.R2, coefficients.G_clipping, Is, eta, Vt);  // Diode solution depends on R2 and G_clipping only
+
+    setDrive(coefficients.drive);
+}
+
+void CircuitModel::setDrive(float driveKnob) noexcept
+{
+    // Interpolated from the cache, no divisions while the knob ramps
+    const auto distortion = coefficientCache->getDistortion(driveKnob);
+
+    coefficients.drive = driveKnob;
+    coefficients.Gb = distortion.Gb;    // (R3 + Rp) * G_distortion
+    coefficients.R1Gb = coefficients.R1 * distortion.Gb;
+    coefficients.Gi = distortion.Gi;    // 1 + R4 * G_distortion
+    coefficients.Gx1 = distortion.Gx1;  // R1 * R4 * G_distortion
+}
+
+void CircuitModel::setLevel(float levelKnob) noexcept
+{
+    coefficients.level = 0.00001f + 0.99998f * levelKnob;
+}
+
+//==============================================================================
+void CircuitModel::reset() noexcept
+{
+    std::fill(groups.begin(), groups.end(), ChannelGroup {});
+}
+
+float CircuitModel::getPeakDiodeVoltage() const noexcept
+{
+    float peak = 0.f;
+
+    for (const auto& group : groups)
+        for (auto diodeVoltage : group.vd)
+            peak = juce::jmax(peak, std::abs(diodeVoltage));
+
+    return peak;
+}
+
+juce::uint32 CircuitModel::flushDenormals() noexcept
+{
+    // Flush-to-zero keeps these normal on most targets. Where it is unavailable a decaying
+    // state turns subnormal and every operation on it slows down. Unused lanes stay at 0
+    juce::uint32 events = 0;
+
+    for (auto& group : groups)
+    {
+        for (auto* states : { group.x1, group.x2, group.vd, group.vdPrevious })
+        {
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                if (std::fpclassify(states[lane]) == FP_SUBNORMAL)
+                {
+                    states[lane] = 0.f;
+                    ++events;
+                }
+            }
+        }
+    }
+
+    return events;
+}
+
+//==============================================================================
+void CircuitModel::process(juce::dsp::AudioBlock<float>& block, const float* driveRamp, const float* levelRamp) noexcept
+{
+    jassert(block.getNumChannels() <= numChannels);
+    jassert(block.getNumSamples() * lanes <= interleavedFrames.size());
+
+    if (driveLevelsEnabled)
+        driveLevels.samples += block.getNumSamples() * block.getNumChannels();
+
+   #if DISRUPTION_HAS_SIMD_LANES
+    // All channels share the coefficients, so they run in groups of FloatLanes::size with
+    // one channel per lane
+    if (simdEnabled && block.getNumChannels() > 1)
+    {
+        for (size_t group = 0; group * lanes < block.getNumChannels(); ++group)
+            processInterleaved(block, group, driveRamp, levelRamp);
+
+        return;
+    }
+   #endif
+
+    processScalar(block, driveRamp, levelRamp);
+}
+
+void CircuitModel::processScalar(juce::dsp::AudioBlock<float>& block, const float* driveRamp, const float* levelRamp) noexcept
+{
+    const auto numBlockChannels = block.getNumChannels();
+    const auto numSamples = block.getNumSamples();
+
+    // Distortion, then clipping, one stage at a time over the whole block. The states and
+    // levels are kept in locals and stored once per channel and block
+    float opAmpPeak = 0.f;
+    juce::uint64 railedSamples = 0;
+
+    for (size_t channel = 0; channel < numBlockChannels; ++channel)
+    {
+        auto* channelData = block.getChannelPointer(channel);
+        auto& group = groups[channel / lanes];
+        const auto lane = channel % lanes;
+        float x1 = group.x1[lane];
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            if (driveRamp != nullptr)
+                setDrive(driveRamp[n]);
+
+            const float Vo = processDistortionSample(channelData[n], x1);
+            opAmpPeak = juce::jmax(opAmpPeak, std::abs(Vo));
+            railedSamples += std::abs(Vo) > railVoltage ? 1u : 0u;
+            channelData[n] = juce::jlimit(-railVoltage, railVoltage, Vo);  // Rails of the op-amp stage
+        }
+
+        group.x1[lane] = x1;
+    }
+
+    notifyStageFinished(StageTimings::distortion);
+
+    float diodePeak = 0.f;
+
+    for (size_t channel = 0; channel < numBlockChannels; ++channel)
+        diodePeak = juce::jmax(diodePeak, processClippingChannel(block.getChannelPointer(channel), 1, numSamples,
+                                                                 groups[channel / lanes], channel % lanes, levelRamp));
+
+    notifyStageFinished(StageTimings::clipping);
+
+    if (driveLevelsEnabled)
+    {
+        driveLevels.opAmpPeak = juce::jmax(driveLevels.opAmpPeak, opAmpPeak);
+        driveLevels.railedSamples += railedSamples;
+        driveLevels.diodePeak = juce::jmax(driveLevels.diodePeak, diodePeak);
+    }
+}
+
+float CircuitModel::processDistortionSample(float Vi, float& x1) const noexcept
+{
+    const float Vb = coefficients.Gb * Vi - coefficients.R1Gb * x1;
+    const float Vr1 = Vi - Vb;
+    const float Vo = coefficients.Gi * Vi - coefficients.Gx1 * x1;
+
+    x1 = coefficients.twoOverR1 * Vr1 - x1;
+    return Vo;
+}
+
+float CircuitModel::processClippingSample(float Vi, float& x2, float& Vd, float& VdPrevious) noexcept
+{
+    const float Vnext = solveDiode(Vi, x2, Vd, VdPrevious);
+
+    VdPrevious = Vd;
+    Vd = Vnext;
+    x2 = coefficients.twoOverR2 * Vd - x2;
+    return coefficients.level * Vd;
+}
+
+float CircuitModel::processClippingChannel(float* samples, size_t stride, size_t numSamples, ChannelGroup& group,
+                                           size_t lane, const float* levelRamp) noexcept
+{
+    float x2 = group.x2[lane];
+    float vd = group.vd[lane];
+    float vdPrevious = group.vdPrevious[lane];
+    float diodePeak = 0.f;
+
+    for (size_t n = 0; n < numSamples; ++n)
+    {
+        if (levelRamp != nullptr)
+            setLevel(levelRamp[n]);
+
+        samples[n * stride] = processClippingSample(samples[n * stride], x2, vd, vdPrevious);
+        diodePeak = juce::jmax(diodePeak, std::abs(vd));
+    }
+
+    group.x2[lane] = x2;
+    group.vd[lane] = vd;
+    group.vdPrevious[lane] = vdPrevious;
+    return diodePeak;
+}
+
+float CircuitModel::solveDiode(float Vi, float x2, float Vd, float VdPrevious) noexcept
+{
+    // The history is kept current with every solver, so switching to an iterative one warm-starts
+    const float p = Vi * coefficients.invR2 + x2;
+    const float warmStart = 2.f * Vd - VdPrevious;  // Linear extrapolation from the last two solutions
+
+    switch (clippingMode)
+    {
+        case ClippingMode::newton:
+        {
+            const auto solution = DiodeSolvers::solveNewton(diodeEquation, p, warmStart);
+            countIterations(solution);
+            return solution.Vd;
+        }
+
+        case ClippingMode::halley:
+        {
+            const auto solution = DiodeSolvers::solveHalley(diodeEquation, p, warmStart);
+            countIterations(solution);
+            return solution.Vd;
+        }
+
+        case ClippingMode::wrightOmega:
+            return DiodeSolvers::solveWrightOmega(diodeEquation, p);
+
+        case ClippingMode::lookupTable:
+            break;
+    }
+
+    return clippingTable->process(Vi, x2);
+}
+
+void CircuitModel::countIterations(const DiodeSolution& solution) noexcept
+{
+    ++statistics.samples;
+    statistics.iterations += static_cast<juce::uint64>(solution.iterations);
+    statistics.maxIterations = juce::jmax(statistics.maxIterations, solution.iterations);
+
+    if (! solution.converged)
+        ++statistics.nonConverged;
+}
+
+float CircuitModel::getDiodeConduction(float diodeVoltage) noexcept
+{
+    const float diodeCurrent = Is * std::sinh(std::abs(diodeVoltage) / (eta * Vt));
+    const float resistorCurrent = std::abs(diodeVoltage) / R5;
+    const float total = diodeCurrent + resistorCurrent;
+    return total > 0.f ? diodeCurrent / total : 0.f;
+}
+
+//==============================================================================
+const char* CircuitModel::getClippingModeName(ClippingMode mode)
+{
+    static const char* const names[] = { "newton", "table", "halley", "omega" };
+    return names[static_cast<int>(mode)];
+}
+
+CircuitModel::ClippingMode CircuitModel::getClippingModeForName(const juce::String& name)
+{
+    for (int mode = 0; mode < numClippingModes; ++mode)
+        if (name == getClippingModeName(static_cast<ClippingMode>(mode)))
+            return static_cast<ClippingMode>(mode);
+
+    return ClippingMode::lookupTable;
+}
+
+float CircuitModel::measureSolverError(ClippingMode mode, int numTestPoints) const
+{
+    jassert(numTestPoints > 1);
+
+    if (mode == ClippingMode::lookupTable)
+        return clippingTable->measureMaxError(numTestPoints);
+
+    // Same range as the table, twice the distortion stage rail over R2
+    const double pMax = 2.0 * railVoltage / coefficients.R2;
+    double maxError = 0.0;
+    float Vd = 0.f, VdPrevious = 0.f;
+
+    for (int i = 0; i < numTestPoints; ++i)
+    {
+        const double p = -pMax + 2.0 * pMax * (i + 0.5) / numTestPoints;
+        const float warmStart = 2.f * Vd - VdPrevious;
+        float solution;
+
+        if (mode == ClippingMode::newton)
+            solution = DiodeSolvers::solveNewton(diodeEquation, static_cast<float>(p), warmStart).Vd;
+        else if (mode == ClippingMode::halley)
+            solution = DiodeSolvers::solveHalley(diodeEquation, static_cast<float>(p), warmStart).Vd;
+        else
+            solution = DiodeSolvers::solveWrightOmega(diodeEquation, static_cast<float>(p));
+
+        VdPrevious = Vd;
+        Vd = solution;
+
+        const double reference = DiodeSolvers::solveReference(p, Is, eta * Vt, diodeEquation.G);
+        maxError = juce::jmax(maxError, std::abs(solution - reference));
+    }
+
+    return static_cast<float>(maxError);
+}
+
+//==============================================================================
+void CircuitModel::processInterleaved(juce::dsp::AudioBlock<float>& block, size_t groupIndex,
+                                      const float* driveRamp, const float* levelRamp) noexcept
+{
+    const auto firstChannel = groupIndex * lanes;
+    const auto numGroupChannels = juce::jmin(lanes, block.getNumChannels() - firstChannel);
+    const auto numSamples = block.getNumSamples();
+
+    auto& group = groups[groupIndex];
+    float* frames = interleavedFrames.data();
+
+    // Interleave the channels into lanes, unused lanes run on silence
+    for (size_t lane = 0; lane < lanes; ++lane)
+    {
+        const float* channelData = lane < numGroupChannels ? block.getChannelPointer(firstChannel + lane) : nullptr;
+
+        for (size_t n = 0; n < numSamples; ++n)
+            frames[n * lanes + lane] = channelData != nullptr ? channelData[n] : 0.f;
+    }
+
+    // Distortion stage, same equations as processDistortionSample
+    {
+        auto gb = FloatLanes::expand(coefficients.Gb);
+        auto r1Gb = FloatLanes::expand(coefficients.R1Gb);
+        auto gi = FloatLanes::expand(coefficients.Gi);
+        auto gx1 = FloatLanes::expand(coefficients.Gx1);
+        const auto twoOverR1 = FloatLanes::expand(coefficients.twoOverR1);
+        const auto upperRail = FloatLanes::expand(railVoltage);
+        const auto lowerRail = FloatLanes::expand(-railVoltage);
+        const auto zero = FloatLanes::expand(0.f);
+        const auto one = FloatLanes::expand(1.f);
+
+        auto x1 = FloatLanes::load(group.x1);
+        auto opAmpPeak = zero;
+        auto railed = zero;  // Per lane counts, exact in float for any block size
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            if (driveRamp != nullptr)
+            {
+                setDrive(driveRamp[n]);
+                gb = FloatLanes::expand(coefficients.Gb);
+                r1Gb = FloatLanes::expand(coefficients.R1Gb);
+                gi = FloatLanes::expand(coefficients.Gi);
+                gx1 = FloatLanes::expand(coefficients.Gx1);
+            }
+
+            const auto Vi = FloatLanes::load(frames + n * lanes);
+            const auto Vb = gb * Vi - r1Gb * x1;
+            const auto Vr1 = Vi - Vb;
+            const auto unclamped = gi * Vi - gx1 * x1;
+            const auto Vo = FloatLanes::min(FloatLanes::max(unclamped, lowerRail), upperRail);
+
+            opAmpPeak = FloatLanes::max(opAmpPeak, FloatLanes::abs(unclamped));
+            railed = railed + FloatLanes::select(FloatLanes::greaterThan(FloatLanes::abs(unclamped), upperRail), one, zero);
+
+            x1 = twoOverR1 * Vr1 - x1;
+            Vo.store(frames + n * lanes);
+        }
+
+        x1.store(group.x1);
+
+        // Unused lanes run on silence, they never rail
+        std::array<float, lanes> peaks {}, railedCounts {};
+        opAmpPeak.store(peaks.data());
+        railed.store(railedCounts.data());
+
+        if (driveLevelsEnabled)
+        {
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                driveLevels.opAmpPeak = juce::jmax(driveLevels.opAmpPeak, peaks[lane]);
+                driveLevels.railedSamples += static_cast<juce::uint64>(railedCounts[lane]);
+            }
+        }
+    }
+
+    notifyStageFinished(StageTimings::distortion);
+
+    // Clipping stage. Newton has a vector version, the other solvers run scalar per lane:
+    // the table lookup is a gather, and Halley and Wright omega need no more than one
+    // transcendental call per lane and iteration
+    if (clippingMode != ClippingMode::newton)
+    {
+        float diodePeak = 0.f;
+
+        for (size_t lane = 0; lane < numGroupChannels; ++lane)
+            diodePeak = juce::jmax(diodePeak, processClippingChannel(frames + lane, lanes, numSamples, group, lane, levelRamp));
+
+        if (driveLevelsEnabled)
+            driveLevels.diodePeak = juce::jmax(driveLevels.diodePeak, diodePeak);
+    }
+    else
+    {
+        // Damped Newton iteration per lane, lanes stop updating once they converge
+        const auto invR2 = FloatLanes::expand(coefficients.invR2);
+        const auto twoOverR2 = FloatLanes::expand(coefficients.twoOverR2);
+        const auto saturation = FloatLanes::expand(Is);
+        const auto saturationSlope = FloatLanes::expand(Is / (eta * Vt));
+        const auto invEtaVt = FloatLanes::expand(1.f / (eta * Vt));
+        const auto conductance = FloatLanes::expand(coefficients.G_clipping);
+        const auto threshold = FloatLanes::expand(thr);
+        auto level = FloatLanes::expand(coefficients.level);
+        const auto zero = FloatLanes::expand(0.f);
+        const auto one = FloatLanes::expand(1.f);
+        const auto two = FloatLanes::expand(2.f);
+        const auto half = FloatLanes::expand(0.5f);
+
+        auto x2 = FloatLanes::load(group.x2);
+        auto vdPrevious = FloatLanes::load(group.vdPrevious);
+        auto vdLast = FloatLanes::load(group.vd);
+
+        // Per lane iteration counts, exact in float for any block size
+        auto laneIterations = zero;
+        auto laneNonConverged = zero;
+        auto diodePeak = zero;
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            if (levelRamp != nullptr)
+            {
+                setLevel(levelRamp[n]);
+                level = FloatLanes::expand(coefficients.level);
+            }
+
+            const auto drive = FloatLanes::load(frames + n * lanes) * invR2 + x2;
+            auto vd = two * vdLast - vdPrevious;  // Linear extrapolation from the last two solutions
+
+            // cosh of the current estimate is carried along for the next derivative, so each
+            // iteration costs one exp and one division
+            FloatLanes sinhVd, coshVd;
+            FloatLanes::sinhCosh(vd * invEtaVt, sinhVd, coshVd);
+            auto fd = saturation * sinhVd + conductance * vd - drive;
+            auto b = one;  // for dampening
+            int i = 0;
+
+            for (; i < 50; ++i)
+            {
+                const auto active = FloatLanes::greaterThan(FloatLanes::abs(fd), threshold);
+
+                if (! FloatLanes::any(active))
+                    break;
+
+                laneIterations = laneIterations + FloatLanes::select(active, one, zero);
+
+                const auto fdd = saturationSlope * coshVd + conductance;
+                const auto vNew = vd - b * fd / fdd;
+                FloatLanes sinhNew, coshNew;
+                FloatLanes::sinhCosh(vNew * invEtaVt, sinhNew, coshNew);
+                const auto fn = saturation * sinhNew + conductance * vNew - drive;
+                const auto better = FloatLanes::lessThan(FloatLanes::abs(fn), FloatLanes::abs(fd));
+                const auto accept = FloatLanes::logicalAnd(active, better);
+
+                vd = FloatLanes::select(accept, vNew, vd);
+                fd = FloatLanes::select(accept, fn, fd);
+                coshVd = FloatLanes::select(accept, coshNew, coshVd);
+                b = FloatLanes::select(better, one, b * half);
+            }
+
+            laneNonConverged = laneNonConverged
+                + FloatLanes::select(FloatLanes::greaterThan(FloatLanes::abs(fd), threshold), one, zero);
+            statistics.maxIterations = juce::jmax(statistics.maxIterations, i);
+
+            vdPrevious = vdLast;
+            vdLast = vd;
+            diodePeak = FloatLanes::max(diodePeak, FloatLanes::abs(vd));
+            x2 = twoOverR2 * vd - x2;
+            (level * vd).store(frames + n * lanes);
+        }
+
+        x2.store(group.x2);
+        vdPrevious.store(group.vdPrevious);
+        vdLast.store(group.vd);
+
+        // Only the lanes that carry a channel count towards the statistics
+        std::array<float, lanes> iterationCounts {}, nonConvergedCounts {}, diodePeaks {};
+        laneIterations.store(iterationCounts.data());
+        laneNonConverged.store(nonConvergedCounts.data());
+        diodePeak.store(diodePeaks.data());
+
+        for (size_t lane = 0; lane < numGroupChannels; ++lane)
+        {
+            statistics.iterations += static_cast<juce::uint64>(iterationCounts[lane]);
+            statistics.nonConverged += static_cast<juce::uint64>(nonConvergedCounts[lane]);
+
+            if (driveLevelsEnabled)
+                driveLevels.diodePeak = juce::jmax(driveLevels.diodePeak, diodePeaks[lane]);
+        }
+
+        statistics.samples += numSamples * numGroupChannels;
+    }
+
+    // Write the lanes back to the channels
+    for (size_t lane = 0; lane < numGroupChannels; ++lane)
+    {
+        float* channelData = block.getChannelPointer(firstChannel + lane);
+
+        for (size_t n = 0; n < numSamples; ++n)
+            channelData[n] = frames[n * lanes + lane];
+    }
+
+    notifyStageFinished(StageTimings::clipping);
+}
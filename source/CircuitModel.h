@@ -0,0 +1,231 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DiodeClipperTable.h"
+#include "CircuitCoefficientCache.h"
+#include "DiodeSolvers.h"
+#include "SIMDLanes.h"
+#include "StageTimings.h"
+#include "DSPArena.h"
+
+//==============================================================================
+// The distortion and clipping stages of the pedal: a wave digital model of the drive
+// RC network and the diode clipper, for any number of channels. It has no dependency on
+// the plugin, so offline tools can run the circuit on its own.
+//
+// Channels are kept in groups of FloatLanes::size. A group's state is one 64 byte
+// ChannelGroup holding each state variable for all its lanes side by side, so the SIMD
+// kernel loads it straight into registers and the scalar code touches a single cache
+// line per group. The coefficients every channel shares fit one cache line as well.
+//
+// prepare() builds the coefficient cache and diode table for every oversampling order,
+// so setOversamplingOrder() on the audio thread only switches pointers.
+class CircuitModel
+{
+public:
+    // Solver used for the diode equation in the clipping stage, see DiodeSolvers.h. The
+    // values are stored in saved state, so new solvers go at the end
+    enum class ClippingMode
+    {
+        newton,       // Damped Newton iteration per sample
+        lookupTable,  // Precomputed solution, fixed cost per sample
+        halley,       // Damped Halley iteration, fewer but costlier iterations than Newton
+        wrightOmega   // Explicit Wright omega solution, fixed cost per sample
+    };
+
+    static constexpr int numClippingModes = 4;
+
+    // Short names for the tools and saved settings, e.g. "newton" or "table"
+    static const char* getClippingModeName(ClippingMode mode);
+    static ClippingMode getClippingModeForName(const juce::String& name);  // Lookup table for unknown names
+
+    // Iterative solver convergence, accumulated over all channels until cleared
+    struct SolverStatistics
+    {
+        juce::uint64 samples = 0;       // Samples solved with Newton or Halley
+        juce::uint64 iterations = 0;    // Iterations over all of those samples
+        juce::uint64 nonConverged = 0;  // Samples that hit the iteration cap
+        int maxIterations = 0;          // Worst single sample
+
+        double getAverageIterations() const { return samples > 0 ? static_cast<double>(iterations) / static_cast<double>(samples) : 0.0; }
+    };
+
+    // How hard the stages were driven, accumulated over all channels until cleared
+    struct DriveLevels
+    {
+        float opAmpPeak = 0.f;           // Largest op-amp output before the rails clamp it, in volts
+        juce::uint64 railedSamples = 0;  // Samples clamped at the rails
+        juce::uint64 samples = 0;        // Channel samples processed
+        float diodePeak = 0.f;           // Largest diode voltage, in volts
+
+        double getRailedFraction() const { return samples > 0 ? static_cast<double>(railedSamples) / static_cast<double>(samples) : 0.0; }
+    };
+
+    // Told when a stage has finished, for callers that time the stages separately. The
+    // interleaved kernel reports both stages once per lane group
+    struct StageListener
+    {
+        virtual ~StageListener() = default;
+        virtual void circuitStageFinished(StageTimings::Stage stage) = 0;
+    };
+
+    CircuitModel();
+
+    // Builds the caches and tables for sampleRate * 2^order, order 0 to numOrders - 1, and
+    // the state for numChannels. maxCircuitBlockSize is the longest block process() gets at
+    // the highest order (not realtime safe)
+    void prepare(double sampleRate, int numOrders, int numChannels, int maxCircuitBlockSize);
+
+    // Switch to a rate built by prepare(), keeps the knob positions
+    void setOversamplingOrder(int order);
+
+    // Retune the active order to any rate, building its cache and table if needed (not
+    // realtime safe)
+    void setSampleRate(double circuitRate);
+    double getSampleRate() const noexcept { return circuitSampleRate; }
+
+    // Knob positions in [0, 1]
+    void setDrive(float driveKnob) noexcept;
+    void setLevel(float levelKnob) noexcept;
+
+    void setClippingMode(ClippingMode newMode) noexcept { clippingMode = newMode; }
+    ClippingMode getClippingMode() const noexcept { return clippingMode; }
+
+    // Interleaved SIMD kernel for more than one channel, mono always uses the scalar code
+    void setSIMDEnabled(bool shouldBeEnabled) noexcept { simdEnabled = shouldBeEnabled; }
+
+    void setStageListener(StageListener* newListener) noexcept { stageListener = newListener; }
+
+    // Runs both stages over a block in place. The ramps hold one knob position per sample
+    // while a knob moves, nullptr keeps the current position. The last ramp value is left
+    // as the knob's position
+    void process(juce::dsp::AudioBlock<float>& block, const float* driveRamp, const float* levelRamp) noexcept;
+
+    // Clear every channel's state
+    void reset() noexcept;
+
+    // Largest diode voltage over all channels, the circuit is still ringing while this is audible
+    float getPeakDiodeVoltage() const noexcept;
+
+    // Clears subnormal states, returns how many there were
+    juce::uint32 flushDenormals() noexcept;
+
+    // Newton and Halley statistics since the last clear, plain counters for the audio thread
+    const SolverStatistics& getSolverStatistics() const noexcept { return statistics; }
+    void clearSolverStatistics() noexcept { statistics = {}; }
+
+    // Stage levels since the last clear, plain values for the audio thread. Only gathered
+    // while enabled, and then added once per block
+    void setDriveLevelsEnabled(bool shouldBeEnabled) noexcept { driveLevelsEnabled = shouldBeEnabled; }
+    const DriveLevels& getDriveLevels() const noexcept { return driveLevels; }
+    void clearDriveLevels() noexcept { driveLevels = {}; }
+
+    // Share of the clipping stage current carried by the diodes at a diode voltage: 0 while
+    // R5 carries it all and the stage is linear, towards 1 as the diodes clip harder
+    static float getDiodeConduction(float diodeVoltage) noexcept;
+
+    // Worst case error of the active lookup table against the Newton reference, in volts
+    float getClippingTableError() const { return clippingTable->measureMaxError(); }
+
+    // Worst case error of a solver against the reference over the range the lookup table
+    // covers, in volts. The iterative solvers are warm started from the previous test point
+    // like they are from the previous sample (not realtime safe)
+    float measureSolverError(ClippingMode mode, int numTestPoints = 100000) const;
+
+    // Component values of the pedal
+    static constexpr float C1 = 47.e-9f;         // Distortion stage capacitor
+    static constexpr float R3 = 4.7e3f;
+    static constexpr float R4 = 1.e6f;
+    static constexpr float potMaximum = 1.e6f;   // Drive pot resistance
+    static constexpr float C2 = 1.e-9f;          // Clipping stage capacitor
+    static constexpr float R5 = 10.e3f;
+
+    // Diode pair
+    static constexpr float eta = 2.f;      // Emission coefficient
+    static constexpr float Is = 1.e-6f;    // Reverse saturation current
+    static constexpr float Vt = 26.e-3f;   // Thermal voltage
+    static constexpr float thr = 1.e-7f;   // Newton convergence threshold on the current
+
+    static constexpr float railVoltage = 4.5f;  // Op-amp output swing, either polarity
+
+    static constexpr int maxOrders = 4;
+
+private:
+    static constexpr size_t lanes = FloatLanes::size;
+
+    // Per-channel state of one lane group. Lane i of every array belongs to channel
+    // 4 * group + i
+    struct alignas(64) ChannelGroup
+    {
+        float x1[lanes];          // Distortion capacitor wave
+        float x2[lanes];          // Clipping capacitor wave
+        float vd[lanes];          // Last diode voltage, warm start for Newton
+        float vdPrevious[lanes];  // Diode voltage one sample before vd
+    };
+
+    static_assert(sizeof(ChannelGroup) == 64, "One cache line per lane group");
+
+    // Everything the per-sample equations read, in one cache line
+    struct alignas(64) Coefficients
+    {
+        // Distortion stage, grouped from the interpolated pot conductance
+        float R1 = 1.f, twoOverR1 = 2.f;
+        float Gb = 0.f, R1Gb = 0.f, Gi = 0.f, Gx1 = 0.f;
+
+        // Clipping stage
+        float R2 = 1.f, invR2 = 1.f, twoOverR2 = 2.f;
+        float G_clipping = 0.f;
+
+        float drive = 0.f;  // Drive knob position
+        float level = 0.f;  // Output gain from the level knob
+    };
+
+    static_assert(sizeof(Coefficients) == 64, "Coefficients fit one cache line");
+
+    Coefficients coefficients;
+    DiodeEquation diodeEquation;  // Clipping stage at the active rate
+
+    void updateRateCoefficients();  // After the cache or table changed
+
+    float processDistortionSample(float Vi, float& x1) const noexcept;  // Op-amp output before the rails
+    float processClippingSample(float Vi, float& x2, float& Vd, float& VdPrevious) noexcept;
+
+    // Clipping stage over numSamples samples stride apart, for the channel in one lane of a
+    // group. Returns the largest diode voltage
+    float processClippingChannel(float* samples, size_t stride, size_t numSamples, ChannelGroup& group, size_t lane, const float* levelRamp) noexcept;
+    float solveDiode(float Vi, float x2, float Vd, float VdPrevious) noexcept;  // With the active solver
+    void countIterations(const DiodeSolution& solution) noexcept;
+
+    void processScalar(juce::dsp::AudioBlock<float>& block, const float* driveRamp, const float* levelRamp) noexcept;
+    void processInterleaved(juce::dsp::AudioBlock<float>& block, size_t group, const float* driveRamp, const float* levelRamp) noexcept;
+
+    void notifyStageFinished(StageTimings::Stage stage)
+    {
+        if (stageListener != nullptr)
+            stageListener->circuitStageFinished(stage);
+    }
+
+    ClippingMode clippingMode = ClippingMode::lookupTable;
+    bool simdEnabled = true;
+    StageListener* stageListener = nullptr;
+
+    SolverStatistics statistics;
+    DriveLevels driveLevels;
+    bool driveLevelsEnabled = false;
+
+    // Index is the oversampling order
+    std::array<CircuitCoefficientCache, maxOrders> coefficientCaches;
+    std::array<DiodeClipperTable, maxOrders> clippingTables;
+    CircuitCoefficientCache* coefficientCache;  // Active order
+    DiodeClipperTable* clippingTable;
+
+    double baseSampleRate = 44100.0;
+    double circuitSampleRate = 0.0;
+
+    DSPArena arena;
+    DSPArena::Array<ChannelGroup> groups;
+    DSPArena::Array<float> interleavedFrames;  // One frame of FloatLanes::size samples per circuit sample
+    size_t numChannels = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CircuitModel)
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// One contiguous, cache aligned allocation for a processor's per-channel state and
+// scratch buffers.
+//
+// build() runs the given function twice, once to measure and once to hand out memory,
+// so the list of buffers is written down in one place. Every allocation starts on its
+// own cache line. The memory is zeroed by build() and stays put until the next build()
+// or the destructor, so the audio thread only ever sees fixed pointers.
+class DSPArena
+{
+public:
+    static constexpr size_t alignment = 64;
+
+    // Non-owning view of one allocation
+    template <typename T>
+    class Array
+    {
+    public:
+        Array() = default;
+        Array(T* elementsToUse, size_t numElementsToUse) noexcept : elements(elementsToUse), numElements(numElementsToUse) {}
+
+        T* data() const noexcept { return elements; }
+        size_t size() const noexcept { return numElements; }
+        bool empty() const noexcept { return numElements == 0; }
+
+        T* begin() const noexcept { return elements; }
+        T* end() const noexcept { return elements + numElements; }
+
+        T& operator[](size_t index) const noexcept
+        {
+            jassert(index < numElements);
+            return elements[index];
+        }
+
+    private:
+        T* elements = nullptr;
+        size_t numElements = 0;
+    };
+
+    DSPArena() = default;
+
+    // Calls assign(*this) to measure, allocates, then calls it again to hand out the
+    // memory (not realtime safe). Arrays from the first call are empty
+    template <typename Function>
+    void build(Function&& assign)
+    {
+        base = nullptr;
+        used = 0;
+        assign(*this);
+
+        const auto bytes = used;
+        storage.allocate(bytes + alignment, true);
+
+        const auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+        base = storage.get() + (alignment - address % alignment) % alignment;
+        used = 0;
+        assign(*this);
+
+        jassert(used == bytes);  // Both calls must ask for the same buffers
+    }
+
+    template <typename T>
+    Array<T> allocate(size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= alignment, "Arena memory is raw and zeroed");
+
+        const auto offset = used;
+        used += (count * sizeof(T) + alignment - 1) / alignment * alignment;
+
+        if (base == nullptr)
+            return {};
+
+        return { reinterpret_cast<T*>(base + offset), count };
+    }
+
+    size_t getNumBytes() const noexcept { return used; }
+
+private:
+    juce::HeapBlock<char> storage;
+    char* base = nullptr;
+    size_t used = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DSPArena)
+};
@@ -0,0 +1,56 @@
+#include "DiodeClipperTable.h"
+
+//==============================================================================
+void DiodeClipperTable::build(float newR2, float newGClipping, float newIs, float newEta, float newVt)
+{
+    R2 = newR2;
+    invR2 = 1.f / R2;
+    G_clipping = newGClipping;
+    Is = newIs;
+    nVt = newEta * newVt;
+
+    // The distortion stage clamps its output at +-4.5 V and the clipping state stays well
+    // below Vi / R2, so twice the rail covers every reachable operating point
+    pMax = 2.f * 4.5f * invR2;
+    scale = static_cast<float>(tableSize) / (2.f * pMax);
+
+    table.resize(tableSize + 1);
+
+    for (size_t i = 0; i < table.size(); ++i)
+    {
+        const double p = -pMax + 2.0 * pMax * static_cast<double>(i) / tableSize;
+        table[i] = static_cast<float>(solveReference(p));
+    }
+}
+
+float DiodeClipperTable::processOutOfRange(float p) const noexcept
+{
+    // Start from the table edge and take one Newton step, so the cost stays fixed
+    const float edge = p > 0.f ? table[tableSize] : table[0];
+    const float fd = Is * std::sinh(edge / nVt) + G_clipping * edge - p;
+    const float fdd = (Is / nVt) * std::cosh(edge / nVt) + G_clipping;
+    return edge - fd / fdd;
+}
+
+double DiodeClipperTable::solveReference(double p) const
+{
+    return DiodeSolvers::solveReference(p, Is, nVt, G_clipping);
+}
+
+float DiodeClipperTable::measureMaxError(int numTestPoints) const
+{
+    jassert(isBuilt() && numTestPoints > 1);
+
+    double maxError = 0.0;
+
+    for (int i = 0; i < numTestPoints; ++i)
+    {
+        // Spread the test points between the table nodes, where the interpolation error peaks
+        const double p = -pMax + 2.0 * pMax * (i + 0.5) / numTestPoints;
+        const float Vi = static_cast<float>(p * R2);
+        const double error = std::abs(process(Vi, 0.f) - solveReference(Vi * invR2));
+        maxError = juce::jmax(maxError, error);
+    }
+
+    return static_cast<float>(maxError);
+}
@@ -0,0 +1,106 @@
+#include "LFO.h"
+
+//==============================================================================
+void LFO::prepare(double newSampleRate, int maximumBlockSize, int numChannels)
+{
+    sampleRate = newSampleRate;
+    values.setSize(numChannels, maximumBlockSize);
+    phaseOffsets.resize(static_cast<size_t>(numChannels), 0.f);
+    reset();
+}
+
+void LFO::setChannelPhaseOffset(int channel, float offsetInCycles) noexcept
+{
+    jassert(juce::isPositiveAndBelow(channel, static_cast<int>(phaseOffsets.size())));
+    phaseOffsets[static_cast<size_t>(channel)] = offsetInCycles - std::floor(offsetInCycles);
+}
+
+void LFO::process(int numSamples) noexcept
+{
+    jassert(numSamples <= values.getNumSamples());
+    const double increment = frequency / sampleRate;
+
+    for (int channel = 0; channel < values.getNumChannels(); ++channel)
+    {
+        double start = phase + phaseOffsets[static_cast<size_t>(channel)];
+        start -= std::floor(start);
+        renderChannel(values.getWritePointer(channel), static_cast<float>(start), static_cast<float>(increment), numSamples);
+    }
+
+    skip(numSamples);
+}
+
+void LFO::skip(int numSamples) noexcept
+{
+    phase += numSamples * (frequency / sampleRate);
+    phase -= std::floor(phase);
+}
+
+void LFO::renderChannel(float* output, float startPhase, float increment, int numSamples) const noexcept
+{
+    // Phase of every sample in [0, 1). Both terms are positive, so truncation wraps it
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const float p = startPhase + static_cast<float>(n) * increment;
+        output[n] = p - static_cast<float>(static_cast<int>(p));
+    }
+
+    switch (shape)
+    {
+        case Shape::sine:
+        {
+            // sin(2 pi p) = -sin(2 pi t) with t = p - 0.5, folded into [-0.25, 0.25] where a
+            // degree 9 polynomial is accurate to a few 1e-6
+            for (int n = 0; n < numSamples; ++n)
+            {
+                float t = output[n] - 0.5f;
+                t = t > 0.25f ? 0.5f - t : (t < -0.25f ? -0.5f - t : t);
+
+                const float x = juce::MathConstants<float>::twoPi * t;
+                const float x2 = x * x;
+                const float s = x * (1.f + x2 * (-1.f / 6.f + x2 * (1.f / 120.f + x2 * (-1.f / 5040.f + x2 * (1.f / 362880.f)))));
+                output[n] = -s;
+            }
+            break;
+        }
+
+        case Shape::triangle:
+        {
+            // Quarter cycle ahead so it lines up with the sine
+            for (int n = 0; n < numSamples; ++n)
+            {
+                float t = output[n] + 0.25f;
+                t -= static_cast<float>(static_cast<int>(t));
+                output[n] = 1.f - 4.f * std::abs(t - 0.5f);
+            }
+            break;
+        }
+
+        case Shape::square:
+        {
+            // High for the first half cycle. The PolyBLEP residual is spread over at least
+            // minimumEdgeSeconds and at most a quarter cycle on each side of an edge
+            const float width = juce::jlimit(increment, 0.25f, static_cast<float>(frequency * minimumEdgeSeconds));
+            const float invWidth = 1.f / width;
+
+            const auto polyBlep = [width, invWidth] (float t)
+            {
+                const float rising = t * invWidth;
+                const float falling = (t - 1.f) * invWidth;
+                return t < width ? rising + rising - rising * rising - 1.f
+                                 : (t > 1.f - width ? falling * falling + falling + falling + 1.f : 0.f);
+            };
+
+            for (int n = 0; n < numSamples; ++n)
+            {
+                const float p = output[n];
+                float halfCycleLater = p + 0.5f;
+                halfCycleLater -= static_cast<float>(static_cast<int>(halfCycleLater));
+
+                const float naive = p < 0.5f ? 1.f : -1.f;
+                output[n] = naive + polyBlep(p) - polyBlep(halfCycleLater);
+            }
+            break;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Low frequency oscillator for the tremolo and chorus, rendered a block at a time.
+//
+// The phase is a double precision accumulator in cycles that advances once per block.
+// Within a block every sample's phase is computed directly from the block start, so the
+// shape loops have no dependency between samples and vectorise. Each channel can run at
+// its own phase offset from the shared accumulator.
+//
+// The square is PolyBLEP smoothed. The correction is at least minimumEdgeSeconds wide,
+// so at tremolo rates the edges become short ramps instead of clicks.
+class LFO
+{
+public:
+    enum class Shape
+    {
+        sine,
+        triangle,
+        square
+    };
+
+    LFO() = default;
+
+    // Allocates the output buffer (not realtime safe)
+    void prepare(double newSampleRate, int maximumBlockSize, int numChannels);
+
+    // Restart at phase 0 plus each channel's offset
+    void reset() noexcept { phase = 0.0; }
+
+    void setShape(Shape newShape) noexcept { shape = newShape; }
+    void setFrequency(float newFrequencyHz) noexcept { frequency = newFrequencyHz; }
+
+    // Offset of one channel from the shared phase, in cycles
+    void setChannelPhaseOffset(int channel, float offsetInCycles) noexcept;
+
+    // Phase of the next sample in cycles, [0, 1)
+    double getPhase() const noexcept { return phase; }
+    void setPhase(double newPhaseInCycles) noexcept { phase = newPhaseInCycles - std::floor(newPhaseInCycles); }
+
+    // Renders the next numSamples values in [-1, 1] for every channel and advances the phase
+    void process(int numSamples) noexcept;
+
+    // Advances the phase without rendering, e.g. while the output is not needed
+    void skip(int numSamples) noexcept;
+
+    // Values of the last process() call
+    const float* getValues(int channel) const noexcept { return values.getReadPointer(channel); }
+
+    static constexpr double minimumEdgeSeconds = 0.002;
+
+private:
+    void renderChannel(float* output, float startPhase, float increment, int numSamples) const noexcept;
+
+    juce::AudioBuffer<float> values;
+    std::vector<float> phaseOffsets;
+
+    double sampleRate = 44100.0;
+    double phase = 0.0;
+    float frequency = 2.f;
+    Shape shape = Shape::square;
+
+    JUCE_LEAK_DETECTOR(LFO)
+};
@@ -0,0 +1,207 @@
+#include "LoadMonitor.h"
+
+//==============================================================================
+LoadMonitor::LoadMonitor()
+    : juce::Thread("Disruption load monitor")
+{
+    reports.resize(static_cast<size_t>(fifoSize));
+}
+
+LoadMonitor::~LoadMonitor()
+{
+    enabled = false;
+    stopThread(2 * updateIntervalMs);
+}
+
+void LoadMonitor::setSummaryActive(bool shouldBeActive)
+{
+    {
+        const juce::ScopedLock sl(consumerLock);
+        summaryActive = shouldBeActive;
+    }
+
+    updateEnabled();
+}
+
+bool LoadMonitor::startLogging(const juce::File& file)
+{
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+
+    if (stream->failedToOpen())
+        return false;
+
+    stream->setPosition(0);
+    stream->truncate();
+
+    *stream << "seconds,load,peakLoad";
+
+    for (int stage = 0; stage < StageTimings::numStages; ++stage)
+        *stream << "," << StageTimings::getStageName(stage);
+
+    *stream << ",averageIterations,denormalEvents,droppedReports\n";
+
+    {
+        const juce::ScopedLock sl(consumerLock);
+        logStream = std::move(stream);
+    }
+
+    updateEnabled();
+    return true;
+}
+
+void LoadMonitor::stopLogging()
+{
+    {
+        const juce::ScopedLock sl(consumerLock);
+        logStream.reset();
+    }
+
+    updateEnabled();
+}
+
+bool LoadMonitor::isLogging() const
+{
+    const juce::ScopedLock sl(consumerLock);
+    return logStream != nullptr;
+}
+
+LoadMonitor::Summary LoadMonitor::getSummary() const
+{
+    const juce::ScopedLock sl(consumerLock);
+    return summary;
+}
+
+void LoadMonitor::push(const BlockReport& report) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+    {
+        droppedReports.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    reports[static_cast<size_t>(start1)] = report;
+    fifo.finishedWrite(1);
+}
+
+//==============================================================================
+void LoadMonitor::updateEnabled()
+{
+    bool shouldRun;
+
+    {
+        const juce::ScopedLock sl(consumerLock);
+        shouldRun = summaryActive || logStream != nullptr;
+    }
+
+    if (shouldRun == isThreadRunning())
+        return;
+
+    if (shouldRun)
+    {
+        // Nothing reads the FIFO while the thread is stopped, so start from an empty one
+        fifo.finishedRead(fifo.getNumReady());
+
+        {
+            const juce::ScopedLock sl(consumerLock);
+            summary = {};
+        }
+
+        droppedReports = 0;
+        startTicks = juce::Time::getHighResolutionTicks();
+        enabled = true;
+        startThread();
+    }
+    else
+    {
+        // Not under consumerLock, drain() takes it
+        enabled = false;
+        stopThread(2 * updateIntervalMs);
+    }
+}
+
+void LoadMonitor::run()
+{
+    while (! threadShouldExit())
+    {
+        wait(updateIntervalMs);
+        drain();
+    }
+}
+
+void LoadMonitor::drain()
+{
+    Summary interval;
+    double processingSeconds = 0.0;
+    double audioSeconds = 0.0;
+    std::array<double, StageTimings::numStages> stageSeconds {};
+    juce::uint64 solverSamples = 0, solverIterations = 0, denormalEvents = 0;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    const auto addReports = [&] (int start, int size)
+    {
+        for (int i = start; i < start + size; ++i)
+        {
+            const auto& report = reports[static_cast<size_t>(i)];
+            const double blockAudioSeconds = report.numSamples / report.sampleRate;
+
+            processingSeconds += report.seconds;
+            audioSeconds += blockAudioSeconds;
+
+            for (size_t stage = 0; stage < stageSeconds.size(); ++stage)
+                stageSeconds[stage] += report.stageSeconds[stage];
+
+            if (blockAudioSeconds > 0.0)
+                interval.peakLoad = juce::jmax(interval.peakLoad, report.seconds / blockAudioSeconds);
+
+            solverSamples += report.solverSamples;
+            solverIterations += report.solverIterations;
+            denormalEvents += report.denormalEvents;
+        }
+    };
+
+    addReports(start1, size1);
+    addReports(start2, size2);
+    fifo.finishedRead(size1 + size2);
+
+    interval.blocks = size1 + size2;
+
+    if (audioSeconds > 0.0)
+    {
+        interval.load = processingSeconds / audioSeconds;
+
+        for (size_t stage = 0; stage < stageSeconds.size(); ++stage)
+            interval.stageLoad[stage] = stageSeconds[stage] / audioSeconds;
+    }
+
+    if (solverSamples > 0)
+        interval.averageIterations = static_cast<double>(solverIterations) / static_cast<double>(solverSamples);
+
+    const juce::ScopedLock sl(consumerLock);
+    interval.denormalEvents = summary.denormalEvents + denormalEvents;
+    interval.droppedReports = droppedReports.load();
+    summary = interval;
+
+    if (logStream != nullptr)
+        writeLogLine(interval);
+}
+
+void LoadMonitor::writeLogLine(const Summary& interval)
+{
+    const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    *logStream << juce::String(seconds, 3) << "," << juce::String(interval.load, 6) << "," << juce::String(interval.peakLoad, 6);
+
+    for (auto stageLoad : interval.stageLoad)
+        *logStream << "," << juce::String(stageLoad, 6);
+
+    *logStream << "," << juce::String(interval.averageIterations, 3)
+               << "," << juce::String(static_cast<juce::int64>(interval.denormalEvents))
+               << "," << juce::String(static_cast<juce::int64>(interval.droppedReports)) << "\n";
+
+    logStream->flush();  // Keep the log complete if the host goes down
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "StageTimings.h"
+
+// Set to 0 to compile the realtime instrumentation out of processBlock. The offline
+// StageTimings hook is kept either way
+#ifndef DISRUPTION_INSTRUMENTATION
+ #define DISRUPTION_INSTRUMENTATION 1
+#endif
+
+//==============================================================================
+// Realtime DSP load of one processor instance.
+//
+// While a consumer is active, processBlock fills one BlockReport per block and pushes it
+// into a single producer, single consumer FIFO. The push never waits or allocates; if the
+// consumer falls behind, the report is dropped and counted. A background thread drains
+// the FIFO every updateIntervalMs, folds the reports into a Summary for the editor and
+// optionally appends one CSV line per interval to a log file.
+class LoadMonitor : private juce::Thread
+{
+public:
+    // Filled by the audio thread
+    struct BlockReport
+    {
+        double seconds = 0.0;  // Whole processBlock
+        std::array<double, StageTimings::numStages> stageSeconds {};
+        double sampleRate = 44100.0;
+        int numSamples = 0;
+        juce::uint32 solverSamples = 0;     // Samples solved with Newton
+        juce::uint32 solverIterations = 0;
+        juce::uint32 denormalEvents = 0;    // Circuit states found subnormal and flushed
+    };
+
+    // Processing time over the real time of the audio it produced, 1 is a full core
+    struct Summary
+    {
+        double load = 0.0;      // Over the last interval
+        double peakLoad = 0.0;  // Worst single block of the last interval
+        std::array<double, StageTimings::numStages> stageLoad {};
+        double averageIterations = 0.0;   // Newton iterations per solved sample
+        juce::uint64 denormalEvents = 0;  // Since the monitor was last started
+        juce::uint64 droppedReports = 0;
+        int blocks = 0;  // Reports in the last interval, 0 while the host is not processing
+    };
+
+    LoadMonitor();
+    ~LoadMonitor() override;
+
+    // Consumers, message thread. The audio thread only reports while at least one is active
+    void setSummaryActive(bool shouldBeActive);
+    bool startLogging(const juce::File& file);  // False if the file could not be opened
+    void stopLogging();
+    bool isLogging() const;
+
+    // Latest interval, any thread but the audio thread
+    Summary getSummary() const;
+
+    // Audio thread
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+    void push(const BlockReport& report) noexcept;
+
+    static constexpr int updateIntervalMs = 250;
+
+private:
+    void run() override;
+    void drain();
+    void updateEnabled();  // Starts or stops the thread to match the consumers
+    void writeLogLine(const Summary& interval);
+
+    // An interval of 16 sample blocks at 192 kHz is 3000 reports
+    static constexpr int fifoSize = 4096;
+    juce::AbstractFifo fifo { fifoSize };
+    std::vector<BlockReport> reports;
+
+    std::atomic<bool> enabled { false };
+    std::atomic<juce::uint64> droppedReports { 0 };
+
+    // Never taken by the audio thread
+    juce::CriticalSection consumerLock;
+    Summary summary;
+    bool summaryActive = false;
+    std::unique_ptr<juce::FileOutputStream> logStream;
+    juce::int64 startTicks = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoadMonitor)
+};
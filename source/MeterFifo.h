@@ -0,0 +1,102 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Levels of one processed block for the editor's meters
+struct MeterBlock
+{
+    float inputPeak = 0.f;         // Over all channels, linear
+    float inputMeanSquare = 0.f;   // Mean over all channel samples
+    float outputPeak = 0.f;
+    float outputMeanSquare = 0.f;
+    float opAmpPeak = 0.f;         // Largest op-amp output the rails were asked for, in volts
+    float railedFraction = 0.f;    // Share of circuit samples clamped at the rails
+    float diodePeak = 0.f;         // Largest diode voltage, in volts
+    int numSamples = 0;
+};
+
+//==============================================================================
+// Wait-free single producer, single consumer queue of MeterBlocks from processBlock to
+// the editor.
+//
+// The audio thread pushes one block at a time: one slot write and an index update, no
+// waiting, and if the editor falls behind the block is dropped. The editor pops every
+// queued block at once, folded into one. Blocks are only pushed while a consumer is
+// active, so a closed editor costs the audio thread a flag check.
+class MeterFifo
+{
+public:
+    MeterFifo() = default;
+
+    // Consumer, message thread
+    void setActive(bool shouldBeActive) noexcept { active.store(shouldBeActive, std::memory_order_relaxed); }
+
+    // Every block since the last call folded into result: peaks are the maxima, mean squares
+    // are weighted by block length. False if nothing was pushed
+    bool pop(MeterBlock& result) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false;
+
+        result = {};
+        double inputSum = 0.0, outputSum = 0.0, railedSum = 0.0;
+
+        const auto fold = [&] (int start, int size)
+        {
+            for (int i = start; i < start + size; ++i)
+            {
+                const auto& block = blocks[static_cast<size_t>(i)];
+                result.inputPeak = juce::jmax(result.inputPeak, block.inputPeak);
+                result.outputPeak = juce::jmax(result.outputPeak, block.outputPeak);
+                result.opAmpPeak = juce::jmax(result.opAmpPeak, block.opAmpPeak);
+                result.diodePeak = juce::jmax(result.diodePeak, block.diodePeak);
+                inputSum += static_cast<double>(block.inputMeanSquare) * block.numSamples;
+                outputSum += static_cast<double>(block.outputMeanSquare) * block.numSamples;
+                railedSum += static_cast<double>(block.railedFraction) * block.numSamples;
+                result.numSamples += block.numSamples;
+            }
+        };
+
+        fold(start1, size1);
+        fold(start2, size2);
+        fifo.finishedRead(size1 + size2);
+
+        if (result.numSamples > 0)
+        {
+            result.inputMeanSquare = static_cast<float>(inputSum / result.numSamples);
+            result.outputMeanSquare = static_cast<float>(outputSum / result.numSamples);
+            result.railedFraction = static_cast<float>(railedSum / result.numSamples);
+        }
+
+        return true;
+    }
+
+    // Producer, audio thread
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    void push(const MeterBlock& block) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+            return;  // Full, the editor is not keeping up
+
+        blocks[static_cast<size_t>(start1)] = block;
+        fifo.finishedWrite(1);
+    }
+
+    // Between two frames at 30 Hz with 16 sample blocks at 192 kHz there are 400 blocks
+    static constexpr int capacity = 1024;
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<MeterBlock, capacity> blocks {};
+    std::atomic<bool> active { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterFifo)
+};
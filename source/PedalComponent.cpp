@@ -16,10 +16,87 @@ void PedalKnobLookAndFeel::drawRotarySlider(
     juce::Slider& slider)
 {
     juce::Rectangle<int> bounds(x, y, width, height);
-    const auto centre = bounds.getCentre().toFloat();
 
     // Check if the slider is the tremolo knob and apply custom styling
-    if (slider.getName() == "Tremolo")
+    const bool tremolo = slider.getName() == "Tremolo";
+    const auto thumbColour = slider.findColour(juce::Slider::thumbColourId);
+
+    if (bodyCacheEnabled)
+    {
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const auto& body = getKnobBody({ width, height, thumbColour.getARGB(), tremolo, scale });
+        g.drawImageTransformed(body, juce::AffineTransform::scale(1.0f / scale).translated(static_cast<float>(x), static_cast<float>(y)));
+    }
+    else
+    {
+        drawKnobBody(g, bounds, thumbColour, tremolo);
+    }
+
+    const float angle = rotaryStartAngle + sliderPosProportional * (rotaryEndAngle - rotaryStartAngle);
+
+    if (tremolo)
+    {
+        // Draw a standard knob indicator
+        const auto knobBounds = bounds.toFloat().reduced(2.0f);
+        const float outerRadius = knobBounds.getWidth() / 2.0f - 1.5f; // Subtract 3 to ensure it stays within outline
+        const float innerRadius = outerRadius * 0.4f;  // Shorter inner radius to stay within bounds
+
+        const juce::Point<float> startPoint = knobBounds.getCentre().getPointOnCircumference(innerRadius, angle);
+        const juce::Point<float> endPoint = knobBounds.getCentre().getPointOnCircumference(outerRadius, angle);
+
+        g.setColour(juce::Colours::yellow.darker(0.1f));
+        g.drawLine({ startPoint, endPoint }, 2.0f); // Standard indicator
+    }
+    else
+    {
+        // Draw Knob Indicator over the innermost ellipse of the body
+        bounds = bounds.reduced(7);
+        const float length = bounds.expanded(4).getWidth();
+
+        const juce::Line<float> indicator(
+            bounds.getCentre().toFloat().getPointOnCircumference(length / 2.0f, angle),
+            bounds.getCentre().toFloat().getPointOnCircumference(length / 5.0f, angle)
+        );
+
+        g.setColour(juce::Colours::black.brighter(0.1f));
+        g.drawLine(indicator, 5);
+    }
+}
+
+void PedalKnobLookAndFeel::setBodyCacheEnabled(bool shouldBeEnabled)
+{
+    bodyCacheEnabled = shouldBeEnabled;
+    bodyCache.clear();
+}
+
+const juce::Image& PedalKnobLookAndFeel::getKnobBody(const KnobBodyKey& key)
+{
+    for (const auto& [cachedKey, image] : bodyCache)
+        if (cachedKey == key)
+            return image;
+
+    if (bodyCache.size() >= maxCachedBodies)
+        bodyCache.erase(bodyCache.begin());
+
+    juce::Image image(juce::Image::ARGB,
+                      juce::jmax(1, juce::roundToInt(key.width * key.scale)),
+                      juce::jmax(1, juce::roundToInt(key.height * key.scale)), true);
+
+    {
+        juce::Graphics g(image);
+        g.addTransform(juce::AffineTransform::scale(key.scale));
+        drawKnobBody(g, { 0, 0, key.width, key.height }, juce::Colour(key.thumbColour), key.tremolo);
+    }
+
+    bodyCache.emplace_back(key, image);
+    return bodyCache.back().second;
+}
+
+void PedalKnobLookAndFeel::drawKnobBody(juce::Graphics& g, juce::Rectangle<int> bounds, juce::Colour thumbColour, bool tremolo)
+{
+    const auto centre = bounds.getCentre().toFloat();
+
+    if (tremolo)
     {
         // Draw the black knob body
         juce::Rectangle<float> knobBounds = bounds.toFloat().reduced(2.0f); // Reduce to create some padding
@@ -39,85 +116,305 @@ void PedalKnobLookAndFeel::drawRotarySlider(
         // Ensure the outline is a complete circle
         g.setColour(juce::Colours::black.brighter(0.1F));
         g.drawEllipse(knobBounds, 1.5f); //thickness for the outline
+        return;
+    }
 
-        // Draw a standard knob indicator
-        const float length = bounds.expanded(5).getWidth();
-        const float angle = rotaryStartAngle + sliderPosProportional * (rotaryEndAngle - rotaryStartAngle);
+    // Normal knob drawing for other knobs (Drive, Level)
+    juce::ColourGradient gradient;
+    gradient.point1 = centre.withY(bounds.getY()).toFloat();
+    gradient.point2 = centre.withX(bounds.getBottom()).toFloat();
+    gradient.addColour(0.0, juce::Colours::white.withAlpha(0.2f));
+    gradient.addColour(1.0, juce::Colours::transparentWhite);
+    gradient.isRadial = true;
+    g.setGradientFill(gradient);
+    g.fillEllipse(bounds.toFloat());
 
-        const float outerRadius = knobBounds.getWidth() / 2.0f - 1.5f; // Subtract 3 to ensure it stays within outline
-        const float innerRadius = outerRadius * 0.4f;  // Shorter inner radius to stay within bounds
+    bounds = bounds.reduced(2);
 
-        const juce::Point<float> startPoint = knobBounds.getCentre().getPointOnCircumference(innerRadius, angle);
-        const juce::Point<float> endPoint = knobBounds.getCentre().getPointOnCircumference(outerRadius, angle);
+    gradient.clearColours();
+    gradient.point1 = centre;
+    gradient.point2 = centre.withX(0).toFloat();
+    gradient.addColour(0.0, juce::Colours::black);
+    gradient.addColour(1.0, juce::Colours::black.brighter(0.2f));
+    gradient.isRadial = true;
+    g.setGradientFill(gradient);
+    g.fillEllipse(bounds.toFloat());
 
-        g.setColour(juce::Colours::yellow.darker(0.1f));
-        g.drawLine({ startPoint, endPoint }, 2.0f); // Standard indicator
+    bounds = bounds.reduced(3);
+
+    thumbColour = thumbColour
+        .withMultipliedSaturation(1.10f)
+        .withMultipliedBrightness(1.85f);
+
+    g.setColour(thumbColour);
+    g.fillEllipse(bounds.toFloat());
+
+    gradient.clearColours();
+    gradient.point1 = centre.withY(bounds.getY()).toFloat();
+    gradient.point2 = centre.withX(bounds.getBottom()).toFloat();
+    gradient.addColour(0.0, thumbColour.brighter());
+    gradient.addColour(1.0, thumbColour.darker());
+    gradient.isRadial = true;
+    g.setGradientFill(gradient);
+    g.fillEllipse(bounds.toFloat());
+
+    bounds = bounds.reduced(2);
+
+    gradient.clearColours();
+    gradient.point1 = centre.withY(bounds.getY()).toFloat();
+    gradient.point2 = centre.withX(bounds.getBottom()).toFloat();
+    gradient.addColour(0.0, thumbColour);
+    gradient.addColour(1.0, thumbColour.darker(0.4f));
+    gradient.isRadial = true;
+    g.setGradientFill(gradient);
+    g.fillEllipse(bounds.toFloat());
+}
+
+//==============================================================================
+// LoadOverlay
+
+LoadOverlay::LoadOverlay(LoadMonitor& m)
+    : monitor(m)
+{
+    setInterceptsMouseClicks(false, false);
+    monitor.setSummaryActive(true);
+    startTimer(LoadMonitor::updateIntervalMs);
+}
+
+LoadOverlay::~LoadOverlay()
+{
+    monitor.setSummaryActive(false);
+}
+
+void LoadOverlay::timerCallback()
+{
+    summary = monitor.getSummary();
+    repaint();
+}
+
+void LoadOverlay::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::black.withAlpha(0.7f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+
+    auto area = getLocalBounds().reduced(6, 4);
+    const auto drawLine = [&g, &area] (const juce::String& text)
+    {
+        g.drawText(text, area.removeFromTop(lineHeight), juce::Justification::centredLeft);
+    };
+
+    const auto percent = [] (double load) { return juce::String(load * 100.0, 2) + " %"; };
+
+    if (summary.blocks == 0)
+    {
+        drawLine("DSP idle");  // Host is not calling processBlock
+        return;
     }
-    else
+
+    drawLine("DSP " + percent(summary.load) + " (peak " + percent(summary.peakLoad) + ")");
+
+    for (int stage = 0; stage < StageTimings::numStages; ++stage)
+        drawLine("  " + juce::String(StageTimings::getStageName(stage)).paddedRight(' ', 13)
+                 + percent(summary.stageLoad[static_cast<size_t>(stage)]));
+
+    drawLine("Newton " + juce::String(summary.averageIterations, 2) + " it/sample");
+    drawLine("Denormals " + juce::String(static_cast<juce::int64>(summary.denormalEvents))
+             + (summary.droppedReports > 0 ? ", dropped " + juce::String(static_cast<juce::int64>(summary.droppedReports)) : juce::String()));
+
+    const auto& opens = resources->getEditorOpenStatistics();
+    drawLine("Editor open " + juce::String(opens.lastSeconds * 1000.0, 1) + " ms (first "
+             + juce::String(opens.firstSeconds * 1000.0, 1) + " ms)");
+}
+
+//==============================================================================
+// LevelMeters
+
+LevelMeters::LevelMeters(MeterFifo& f)
+    : fifo(f),
+      vBlank(this, [this] { update(); })
+{
+    setInterceptsMouseClicks(false, false);
+    fifo.setActive(true);
+}
+
+LevelMeters::~LevelMeters()
+{
+    fifo.setActive(false);
+}
+
+void LevelMeters::update()
+{
+    const double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    const float release = static_cast<float>(juce::jlimit(0.0, 0.1, now - lastUpdateSeconds)) * releasePerSecond;
+    lastUpdateSeconds = now;
+
+    std::array<Bar, numMeters> targets {};
+    MeterBlock block;
+
+    if (fifo.pop(block))
     {
-        // Normal knob drawing for other knobs (Drive, Level)
-        juce::ColourGradient gradient;
-        gradient.point1 = centre.withY(bounds.getY()).toFloat();
-        gradient.point2 = centre.withX(bounds.getBottom()).toFloat();
-        gradient.addColour(0.0, juce::Colours::white.withAlpha(0.2f));
-        gradient.addColour(1.0, juce::Colours::transparentWhite);
-        gradient.isRadial = true;
-        g.setGradientFill(gradient);
-        g.fillEllipse(bounds.toFloat());
+        const auto levelToBar = [] (float gain)
+        {
+            return juce::jmap(juce::jlimit(minimumDb, 0.f, juce::Decibels::gainToDecibels(gain, minimumDb)), minimumDb, 0.f, 0.f, 1.f);
+        };
 
-        bounds = bounds.reduced(2);
+        targets[0] = { levelToBar(block.inputPeak), levelToBar(std::sqrt(block.inputMeanSquare)) };
+        targets[1] = { levelToBar(block.outputPeak), levelToBar(std::sqrt(block.outputMeanSquare)) };
 
-        gradient.clearColours();
-        gradient.point1 = centre;
-        gradient.point2 = centre.withX(0).toFloat();
-        gradient.addColour(0.0, juce::Colours::black);
-        gradient.addColour(1.0, juce::Colours::black.brighter(0.2f));
-        gradient.isRadial = true;
-        g.setGradientFill(gradient);
-        g.fillEllipse(bounds.toFloat());
+        // The rails sit in the middle of the bar, the right half is how far beyond them the stage is pushed
+        targets[2] = { juce::jmin(1.f, block.opAmpPeak / (2.f * CircuitModel::railVoltage)), block.railedFraction };
+        targets[3] = { CircuitModel::getDiodeConduction(block.diodePeak), 0.f };
+    }
 
-        bounds = bounds.reduced(3);
+    // Instant attack, constant release
+    bool changed = false;
 
-        const auto thumbColour = slider
-            .findColour(juce::Slider::thumbColourId)
-            .withMultipliedSaturation(1.10f)
-            .withMultipliedBrightness(1.85f);
+    for (size_t i = 0; i < bars.size(); ++i)
+    {
+        Bar next { juce::jmax(targets[i].value, bars[i].value - release), juce::jmax(targets[i].inner, bars[i].inner - release) };
 
-        g.setColour(thumbColour);
-        g.fillEllipse(bounds.toFloat());
+        if (std::abs(next.value - bars[i].value) > 1.e-3f || std::abs(next.inner - bars[i].inner) > 1.e-3f)
+            changed = true;
 
-        gradient.clearColours();
-        gradient.point1 = centre.withY(bounds.getY()).toFloat();
-        gradient.point2 = centre.withX(bounds.getBottom()).toFloat();
-        gradient.addColour(0.0, thumbColour.brighter());
-        gradient.addColour(1.0, thumbColour.darker());
-        gradient.isRadial = true;
-        g.setGradientFill(gradient);
-        g.fillEllipse(bounds.toFloat());
+        bars[i] = next;
+    }
 
-        bounds = bounds.reduced(2);
+    if (changed)
+        repaint();
+}
 
-        gradient.clearColours();
-        gradient.point1 = centre.withY(bounds.getY()).toFloat();
-        gradient.point2 = centre.withX(bounds.getBottom()).toFloat();
-        gradient.addColour(0.0, thumbColour);
-        gradient.addColour(1.0, thumbColour.darker(0.4f));
-        gradient.isRadial = true;
-        g.setGradientFill(gradient);
-        g.fillEllipse(bounds.toFloat());
+void LevelMeters::paint(juce::Graphics& g)
+{
+    static const char* const names[] = { "IN", "OUT", "RAIL", "DIODE" };
 
-        // Draw Knob Indicator
-        const float length = bounds.expanded(4).getWidth();
-        const float angle = rotaryStartAngle + sliderPosProportional * (rotaryEndAngle - rotaryStartAngle);
+    g.setFont(10.0f);
+    auto area = getLocalBounds();
 
-        const juce::Line<float> indicator(
-            bounds.getCentre().getPointOnCircumference(length / 2.0f, angle),
-            bounds.getCentre().getPointOnCircumference(length / 5.0f, angle)
-        );
+    for (size_t i = 0; i < bars.size(); ++i)
+    {
+        auto row = area.removeFromTop(rowHeight);
+        g.setColour(juce::Colours::white.withAlpha(0.7f));
+        g.drawText(names[i], row.removeFromLeft(40), juce::Justification::centredLeft);
+
+        const auto track = row.reduced(0, 3).toFloat();
+        g.setColour(juce::Colours::black.withAlpha(0.4f));
+        g.fillRect(track);
+
+        const bool railing = i == 2 && bars[i].value > 0.5f;
+        g.setColour(railing ? juce::Colours::orange : juce::Colours::white.withAlpha(0.8f));
+        g.fillRect(track.withWidth(track.getWidth() * bars[i].value));
+
+        g.setColour(juce::Colours::black.withAlpha(0.5f));
+        g.fillRect(track.reduced(0, 2).withWidth(track.getWidth() * bars[i].inner));
+
+        if (i == 2)
+        {
+            g.setColour(juce::Colours::white.withAlpha(0.5f));
+            g.drawVerticalLine(juce::roundToInt(track.getCentreX()), track.getY(), track.getBottom());
+        }
+    }
+}
 
-        g.setColour(juce::Colours::black.brighter(0.1f));
-        g.drawLine(indicator, 5);
+//==============================================================================
+// AnalyserView
+
+AnalyserView::AnalyserView(SpectrumAnalyser& a)
+    : analyser(a),
+      vBlank(this, [this] { update(); })
+{
+    setInterceptsMouseClicks(false, false);
+    frame.spectrum.fill(SpectrumAnalyser::minimumDb);
+    analyser.setActive(true);
+}
+
+AnalyserView::~AnalyserView()
+{
+    analyser.setActive(false);
+}
+
+void AnalyserView::update()
+{
+    const int latestCount = analyser.getFrameCount();
+
+    if (latestCount == frameCount)
+        return;
+
+    frameCount = latestCount;
+    frame = analyser.getFrame();
+    repaint();
+}
+
+void AnalyserView::paint(juce::Graphics& g)
+{
+    const auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colours::black.withAlpha(0.75f));
+    g.fillRoundedRectangle(bounds, 5.0f);
+
+    auto area = bounds.reduced(4.0f);
+    const auto scopeArea = area.removeFromTop(area.getHeight() * scopeHeightProportion);
+    const auto spectrumArea = area.withTrimmedTop(4.0f);
+
+    // Frequency grid at 100 Hz, 1 kHz and 10 kHz, level grid every 24 dB
+    const float bandsPerOctave = SpectrumAnalyser::numBands
+        / std::log2(static_cast<float>(frame.sampleRate * 0.5) / SpectrumAnalyser::minimumFrequency);
+
+    const auto frequencyToX = [&] (float frequency)
+    {
+        const float band = std::log2(frequency / SpectrumAnalyser::minimumFrequency) * bandsPerOctave;
+        return spectrumArea.getX() + spectrumArea.getWidth() * band / SpectrumAnalyser::numBands;
+    };
+
+    const auto levelToY = [&] (float db)
+    {
+        return juce::jmap(juce::jlimit(displayMinimumDb, 0.f, db), displayMinimumDb, 0.f, spectrumArea.getBottom(), spectrumArea.getY());
+    };
+
+    g.setColour(juce::Colours::white.withAlpha(0.15f));
+
+    for (float frequency : { 100.f, 1000.f, 10000.f })
+        g.drawVerticalLine(juce::roundToInt(frequencyToX(frequency)), spectrumArea.getY(), spectrumArea.getBottom());
+
+    for (float db = -24.f; db > displayMinimumDb; db -= 24.f)
+        g.drawHorizontalLine(juce::roundToInt(levelToY(db)), spectrumArea.getX(), spectrumArea.getRight());
+
+    g.drawHorizontalLine(juce::roundToInt(scopeArea.getCentreY()), scopeArea.getX(), scopeArea.getRight());
+
+    // Spectrum
+    juce::Path spectrum;
+
+    for (int band = 0; band < SpectrumAnalyser::numBands; ++band)
+    {
+        const float x = spectrumArea.getX() + spectrumArea.getWidth() * (band + 0.5f) / SpectrumAnalyser::numBands;
+        const float y = levelToY(frame.spectrum[static_cast<size_t>(band)]);
+
+        if (band == 0)
+            spectrum.startNewSubPath(x, y);
+        else
+            spectrum.lineTo(x, y);
     }
+
+    g.setColour(juce::Colours::orange);
+    g.strokePath(spectrum, juce::PathStrokeType(1.2f));
+
+    // Scope, full scale fills the height
+    juce::Path scope;
+
+    for (int point = 0; point < SpectrumAnalyser::numScopePoints; ++point)
+    {
+        const float x = scopeArea.getX() + scopeArea.getWidth() * point / (SpectrumAnalyser::numScopePoints - 1);
+        const float y = scopeArea.getCentreY() - 0.5f * scopeArea.getHeight() * juce::jlimit(-1.f, 1.f, frame.scope[static_cast<size_t>(point)]);
+
+        if (point == 0)
+            scope.startNewSubPath(x, y);
+        else
+            scope.lineTo(x, y);
+    }
+
+    g.setColour(juce::Colours::white.withAlpha(0.8f));
+    g.strokePath(scope, juce::PathStrokeType(1.0f));
 }
 
 //==============================================================================
@@ -130,28 +427,27 @@ PedalComponent::PedalComponent(DisruptionAudioProcessor& p,
     const KnobNames& knobNames)
     : AudioProcessorEditor(&p), processor(p), colour(colour), tremoloKnobVisible(false)
 {
-    setSize(300, 500); // Set the size of the plugin window
+    openStartTicks = juce::Time::getHighResolutionTicks();
+    artworkLabels = juce::String(name) + "|" + knobNames.first + "|" + knobNames.second;
 
-    // Load images from resources
-    boltOffImage = juce::ImageCache::getFromMemory(BinaryData::boltOff_png, BinaryData::boltOff_pngSize);
-    boltOnImage = juce::ImageCache::getFromMemory(BinaryData::boltOn_png, BinaryData::boltOn_pngSize);
-    disruptionLogoImage = juce::ImageCache::getFromMemory(BinaryData::disruptionlogo_png, BinaryData::disruptionlogo_pngSize);
+    setSize(300, 500); // Set the size of the plugin window
 
-    // Load Font from BinaryData
-    juce::Typeface::Ptr customTypeface = juce::Typeface::createSystemTypefaceFor(BinaryData::fightingspirittbs_regular_ttf, BinaryData::fightingspirittbs_regular_ttfSize);
-    juce::Font customFont(customTypeface.get());
+    // Shared with every other editor, only the first one decodes them
+    boltOffImage = resources->getImage(PedalResources::ImageID::boltOff);
+    boltOnImage = resources->getImage(PedalResources::ImageID::boltOn);
+    disruptionLogoImage = resources->getImage(PedalResources::ImageID::logo);
 
     // Initialize knobs
     for (int i = 0; i < 2; ++i)
     {
         knobs[i].setSliderStyle(juce::Slider::Rotary);
         knobs[i].setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
-        knobs[i].setRange(0.0, 1.0);
-        knobs[i].setValue((i == 0) ? processor.getDistortionValue() : processor.getLevelValue());
+        knobAttachments[i] = std::make_unique<SliderAttachment>(processor.getParameters(),
+                                                                (i == 0) ? ParameterIDs::drive : ParameterIDs::level,
+                                                                knobs[i]);
         knobs[i].setColour(juce::Slider::rotarySliderFillColourId, colour);
         knobs[i].setColour(juce::Slider::thumbColourId, juce::Colours::white);
         knobs[i].setLookAndFeel(lookAndFeel);
-        knobs[i].addListener(this);
         addAndMakeVisible(knobs[i]);
     }
 
@@ -162,36 +458,70 @@ PedalComponent::PedalComponent(DisruptionAudioProcessor& p,
     tremoloKnob.setName("Tremolo");
     tremoloKnob.setSliderStyle(juce::Slider::Rotary);
     tremoloKnob.setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
-    tremoloKnob.setRange(0.1, 10.0); // Adjust the range as needed
-    tremoloKnob.setValue(5.0); // Default value
+    tremoloKnobAttachment = std::make_unique<SliderAttachment>(processor.getParameters(), ParameterIDs::tremoloRate, tremoloKnob);
     tremoloKnob.setColour(juce::Slider::rotarySliderFillColourId, juce::Colours::black);
     tremoloKnob.setColour(juce::Slider::thumbColourId, juce::Colours::yellow);
     tremoloKnob.setLookAndFeel(lookAndFeel);
-    tremoloKnob.addListener(this);
-    tremoloKnob.setVisible(false); // Start hidden
+    tremoloKnobVisible = processor.isTremoloOn(); // Reopening the editor restores the footswitch state
+    isLightOn = tremoloKnobVisible;
+    tremoloKnob.setVisible(tremoloKnobVisible);
     addAndMakeVisible(tremoloKnob);
 
     // Initialize the label for the tremolo knob
-    tremoloLabel.setFont(customFont); // Use the custom font
+    tremoloLabel.setFont(juce::Font(resources->getTypeface())); // Use the custom font
     tremoloLabel.setText("DISRUPTION", juce::dontSendNotification);
     tremoloLabel.setColour(juce::Label::textColourId, juce::Colours::white);
     tremoloLabel.setJustificationType(juce::Justification::centred);
-    tremoloLabel.setVisible(false); // Start hidden
+    tremoloLabel.setVisible(tremoloKnobVisible);
     addAndMakeVisible(tremoloLabel);
 
-    // Enable buffered image for performance
-    setBufferedToImage(true);
+    levelMeters = std::make_unique<LevelMeters>(processor.getMeterFifo());
+    addAndMakeVisible(*levelMeters);
+
+    // The knobs repaint their own bounds when they move, and the static layer behind them
+    // is already an image, so the editor is not buffered as a whole
+    startTimerHz(indicatorRefreshHz);
 }
 
 // Destructor definition
 PedalComponent::~PedalComponent()
 {
+    stopTimer();
+    loadOverlay.reset();
+    levelMeters.reset();
+    analyserView.reset();
     knobs[0].setLookAndFeel(nullptr);
     knobs[1].setLookAndFeel(nullptr);
     tremoloKnob.setLookAndFeel(nullptr);
 }
 
 void PedalComponent::paint(juce::Graphics& g)
+{
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    const PedalResources::ArtworkKey key { getWidth(), getHeight(), scale, colour.getARGB(), artworkLabels };
+
+    if (staticLayer.isNull() || ! (staticLayerKey == key))
+    {
+        staticLayer = resources->getArtwork(key, [this] (juce::Graphics& layer) { drawStaticLayer(layer); });
+        staticLayerKey = key;
+    }
+
+    g.drawImageTransformed(staticLayer, juce::AffineTransform::scale(1.0f / scale));
+
+    // Draw indicator light based on button state
+    const auto& lightImage = isLightOn ? boltOnImage : boltOffImage;
+    const auto lightArea = getBoltArea();
+    g.drawImageWithin(lightImage, lightArea.getX(), lightArea.getY(), lightArea.getWidth(), lightArea.getHeight(), juce::RectanglePlacement::centred);
+
+    if (openStartTicks != 0)
+    {
+        resources->recordEditorOpen(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - openStartTicks));
+        openStartTicks = 0;
+    }
+}
+
+void PedalComponent::drawStaticLayer(juce::Graphics& g)
 {
     g.fillAll(juce::Colours::midnightblue); // Pedal background color
 
@@ -225,11 +555,6 @@ void PedalComponent::paint(juce::Graphics& g)
         logoBounds.getWidth(), logoBounds.getHeight(),
         juce::RectanglePlacement::centred);
 
-    // Draw indicator light based on button state
-    juce::Image lightImage = isLightOn ? boltOnImage : boltOffImage;
-    auto lightArea = juce::Rectangle<int>(getWidth() / 2 - 15, 10, 30, 30);
-    g.drawImageWithin(lightImage, lightArea.getX(), lightArea.getY(), lightArea.getWidth(), lightArea.getHeight(), juce::RectanglePlacement::centred);
-
     // Draw Knob Labels
     g.setColour(juce::Colours::white);
     g.setFont(16.0f);
@@ -245,21 +570,143 @@ void PedalComponent::paint(juce::Graphics& g)
 
 void PedalComponent::mouseUp(const juce::MouseEvent& e)
 {
+    if (e.mods.isPopupMenu())
+    {
+        showSettingsMenu();
+        return;
+    }
+
     auto area = getLocalBounds().reduced(10);
 
     if (area.contains(e.getPosition()))
     {
-        // Toggle the effect on/off state
-        processor.setEffectOn(!processor.isEffectOn());        
-        tremoloKnobVisible = !tremoloKnobVisible; // Toggle visibility
-        tremoloKnob.setVisible(tremoloKnobVisible);
-        tremoloLabel.setVisible(tremoloKnobVisible);
-        processor.setTremoloOn(tremoloKnobVisible); // Enable or disable tremolo effect based on knob visibility
-        isLightOn = !isLightOn; // Toggle the light state
-        resized(); // Update layout when visibility changes
-        repaint(); // Repaint to update light
+        // The footswitch toggles the Disruption (tremolo and chorus) side of the pedal,
+        // bypass is left to the host's own switch
+        processor.setTremoloOn(! tremoloKnobVisible);
+        setFootswitchState(! tremoloKnobVisible);
+    }
+}
+
+void PedalComponent::timerCallback()
+{
+    // Host automation and preset changes can switch the Disruption side as well
+    if (processor.isTremoloOn() != tremoloKnobVisible)
+        setFootswitchState(processor.isTremoloOn());
+}
+
+void PedalComponent::setFootswitchState(bool isOn)
+{
+    tremoloKnobVisible = isOn;
+    tremoloKnob.setVisible(tremoloKnobVisible);
+    tremoloLabel.setVisible(tremoloKnobVisible);
+    isLightOn = isOn;
+    resized(); // Update layout when visibility changes
+    repaint(getBoltArea()); // Only the light changes, the rest of the pedal is the cached layer
+}
+
+void PedalComponent::showSettingsMenu()
+{
+    using LatencyMode = DisruptionAudioProcessor::LatencyMode;
+    using OversamplingFactor = DisruptionAudioProcessor::OversamplingFactor;
+    using ClippingMode = DisruptionAudioProcessor::ClippingMode;
+
+    // Latencies are shown for the current oversampling factor
+    juce::PopupMenu latencyMenu;
+    const auto currentMode = processor.getLatencyMode();
+    const std::pair<LatencyMode, const char*> modes[] = { { LatencyMode::zeroLatency, "Zero latency" },
+                                                          { LatencyMode::lowLatency, "Low latency" },
+                                                          { LatencyMode::highQuality, "High quality" } };
+
+    for (const auto& [mode, name] : modes)
+        latencyMenu.addItem(juce::String(name) + " (" + juce::String(processor.getLatencyForMode(mode)) + " samples)",
+                            true, mode == currentMode, [this, mode = mode] { processor.setLatencyMode(mode); });
+
+    juce::PopupMenu oversamplingMenu;
+    const auto currentFactor = processor.getOversamplingFactor();
 
+    for (int order = 0; order < 4; ++order)
+    {
+        const auto factor = static_cast<OversamplingFactor>(order);
+        oversamplingMenu.addItem(juce::String(1 << order) + "x", currentMode != LatencyMode::zeroLatency, factor == currentFactor,
+                                 [this, factor] { processor.setOversamplingFactor(factor); });
+    }
+
+    // From the most precise to the cheapest
+    juce::PopupMenu solverMenu;
+    const auto currentSolver = processor.getClippingMode();
+    const std::pair<ClippingMode, const char*> solvers[] = { { ClippingMode::newton, "Newton" },
+                                                             { ClippingMode::halley, "Halley" },
+                                                             { ClippingMode::wrightOmega, "Wright omega" },
+                                                             { ClippingMode::lookupTable, "Lookup table" } };
+
+    for (const auto& [solver, name] : solvers)
+        solverMenu.addItem(name, true, solver == currentSolver, [this, solver = solver] { processor.setClippingMode(solver); });
+
+    juce::PopupMenu menu;
+    menu.addSubMenu("Latency", latencyMenu);
+    menu.addSubMenu("Oversampling", oversamplingMenu);
+    menu.addSubMenu("Diode solver", solverMenu);
+    menu.addItem("Show analyser", true, analyserView != nullptr,
+                 [this] { setAnalyserVisible(analyserView == nullptr); });
+
+   #if DISRUPTION_INSTRUMENTATION
+    menu.addSeparator();
+    menu.addItem("Show DSP load", true, loadOverlay != nullptr,
+                 [this] { setLoadOverlayVisible(loadOverlay == nullptr); });
+    menu.addItem("Log DSP load to Documents", true, processor.getLoadMonitor().isLogging(),
+                 [this] { setLoadLogging(! processor.getLoadMonitor().isLogging()); });
+   #endif
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this).withMousePosition());
+}
+
+void PedalComponent::setLoadOverlayVisible(bool shouldBeVisible)
+{
+    if (! shouldBeVisible)
+    {
+        loadOverlay.reset();
+        return;
+    }
+
+    loadOverlay = std::make_unique<LoadOverlay>(processor.getLoadMonitor());
+    loadOverlay->setBounds(10, 10, 170, LoadOverlay::numLines * LoadOverlay::lineHeight + 8);
+    addAndMakeVisible(*loadOverlay);
+}
+
+void PedalComponent::setAnalyserVisible(bool shouldBeVisible)
+{
+    if (! shouldBeVisible)
+    {
+        analyserView.reset();
+        return;
+    }
+
+    // Over the knobs, they stay usable through it
+    analyserView = std::make_unique<AnalyserView>(processor.getSpectrumAnalyser());
+    analyserView->setBounds(10, 10, getWidth() - 20, 150);
+    addAndMakeVisible(*analyserView);
+
+    if (loadOverlay != nullptr)
+        loadOverlay->toFront(false);
+}
+
+void PedalComponent::setLoadLogging(bool shouldLog)
+{
+    auto& monitor = processor.getLoadMonitor();
+
+    if (! shouldLog)
+    {
+        monitor.stopLogging();
+        return;
     }
+
+    // Keeps logging after the editor closes, until switched off or the plugin is removed
+    const auto file = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                          .getNonexistentChildFile("Disruption DSP load", ".csv");
+
+    if (! monitor.startLogging(file))
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Disruption",
+                                               "Could not write " + file.getFullPathName());
 }
 
 // New method to handle pedal decorations (shadows, rubber areas, etc.)
@@ -383,6 +830,10 @@ void PedalComponent::resized()
 
     flexbox.performLayout(area);
 
+    // Between the knobs and the foot area
+    if (levelMeters != nullptr)
+        levelMeters->setBounds(30, 250, getWidth() - 60, LevelMeters::numMeters * LevelMeters::rowHeight);
+
     // Center the third knob below the first two if it's visible
     if (tremoloKnobVisible)
     {
@@ -416,17 +867,3 @@ void PedalComponent::resized()
     }
 }
 
-void PedalComponent::sliderValueChanged(juce::Slider* slider) {
-    if (slider == &knobs[0]) {
-        processor.setDistortionValue(knobs[0].getValue());  // Use the setter
-    }
-    if (slider == &knobs[1]) {
-        processor.setLevelValue(knobs[1].getValue());  // Use the setter
-    }
-
-    {
-        // Handle tremolo knob changes
-        processor.setTremoloRate(tremoloKnob.getValue());
-    }
-    repaint(); // Trigger repaint to update the UI
-}
@@ -2,9 +2,14 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "LoadMonitor.h"
+#include "PedalResources.h"
 
 using KnobNames = std::pair<juce::StringRef, juce::StringRef>;
 
+// Knobs of the pedal. Shared by every editor through a SharedResourcePointer, so the knob
+// bodies (all of a knob but its indicator) are rendered once per size, colour and pixel
+// scale for the whole process, and a knob repaint is an image blit plus one line.
 class PedalKnobLookAndFeel : public juce::LookAndFeel_V4 {
 public:
     PedalKnobLookAndFeel() = default;
@@ -22,14 +27,122 @@ public:
         juce::Slider& slider
     ) override;
 
+    // Off draws every gradient on each repaint, for comparing paint times
+    void setBodyCacheEnabled(bool shouldBeEnabled);
+    size_t getNumCachedBodies() const { return bodyCache.size(); }
+
+    static constexpr size_t maxCachedBodies = 16;  // Oldest is dropped beyond this
+
 private:
+    struct KnobBodyKey
+    {
+        int width = 0, height = 0;
+        juce::uint32 thumbColour = 0;  // ARGB
+        bool tremolo = false;
+        float scale = 1.f;  // Physical pixels per logical pixel
+
+        bool operator==(const KnobBodyKey& other) const
+        {
+            return width == other.width && height == other.height && thumbColour == other.thumbColour
+                && tremolo == other.tremolo && scale == other.scale;
+        }
+    };
+
+    const juce::Image& getKnobBody(const KnobBodyKey& key);
+    static void drawKnobBody(juce::Graphics& g, juce::Rectangle<int> bounds, juce::Colour thumbColour, bool tremolo);
+
+    bool bodyCacheEnabled = true;
+    std::vector<std::pair<KnobBodyKey, juce::Image>> bodyCache;  // Message thread only
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PedalKnobLookAndFeel)
 };
 
 class DisruptionAudioProcessor;
 
-class PedalComponent : public juce::AudioProcessorEditor, public juce::Slider::Listener {
+// DSP load readout drawn over the pedal, keeps the load monitor collecting while it exists.
+// The last line is how long editors took to open
+class LoadOverlay : public juce::Component, private juce::Timer {
+public:
+    explicit LoadOverlay(LoadMonitor& monitor);
+    ~LoadOverlay() override;
+
+    void paint(juce::Graphics& g) override;
+
+    static constexpr int lineHeight = 13;
+    static constexpr int numLines = StageTimings::numStages + 4;
+
+private:
+    void timerCallback() override;
+
+    LoadMonitor& monitor;
+    LoadMonitor::Summary summary;
+    juce::SharedResourcePointer<PedalResources> resources;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoadOverlay)
+};
+
+// Input and output level, op-amp rail and diode drive meters. Reads the processor's
+// MeterFifo once per display frame and keeps it filled while the meters exist
+class LevelMeters : public juce::Component {
+public:
+    explicit LevelMeters(MeterFifo& fifo);
+    ~LevelMeters() override;
+
+    void paint(juce::Graphics& g) override;
+
+    static constexpr int numMeters = 4;
+    static constexpr int rowHeight = 12;
+    static constexpr float minimumDb = -60.f;           // Bottom of the level meters
+    static constexpr float releasePerSecond = 1.5f;     // Bar fall, full scale per second
+
+private:
+    void update();
+
+    // Bar lengths in [0, 1]: the main bar and a thinner one inside it (RMS for the level
+    // meters, share of railed samples for the rail meter)
+    struct Bar
+    {
+        float value = 0.f;
+        float inner = 0.f;
+    };
+
+    MeterFifo& fifo;
+    std::array<Bar, numMeters> bars;
+    double lastUpdateSeconds = 0.0;
+    juce::VBlankAttachment vBlank;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeters)
+};
+
+// Spectrum and scope of the processor output drawn over the pedal. The analyser only
+// captures and transforms while this exists, the view copies a frame when a new one is ready
+class AnalyserView : public juce::Component {
+public:
+    explicit AnalyserView(SpectrumAnalyser& analyser);
+    ~AnalyserView() override;
+
+    void paint(juce::Graphics& g) override;
+
+    static constexpr float displayMinimumDb = -96.f;
+    static constexpr float scopeHeightProportion = 0.3f;  // Top of the view, the spectrum is below
+
+private:
+    void update();
+
+    SpectrumAnalyser& analyser;
+    SpectrumAnalyser::Frame frame;
+    int frameCount = 0;
+    juce::VBlankAttachment vBlank;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyserView)
+};
+
+// The pedal editor. Everything that does not move (body, decorations, logo, knob labels)
+// is rendered once into staticLayer and blitted, so a knob or the bolt indicator
+// repainting its own bounds only costs a copy of the layer behind it. The layer, images
+// and typeface come from PedalResources, so editors after the first one of the process
+// neither decode nor render anything.
+class PedalComponent : public juce::AudioProcessorEditor, private juce::Timer {
 public:
     PedalComponent(DisruptionAudioProcessor& p,
                    const juce::StringRef& name,
@@ -41,22 +154,48 @@ public:
 
     void paint(juce::Graphics& g) override;
     void resized() override;
-    void sliderValueChanged(juce::Slider* slider) override;
+
+    // Rate of the timer that follows footswitch changes made by the host
+    static constexpr int indicatorRefreshHz = 30;
 
 private:
     void mouseUp(const juce::MouseEvent& e) override;
+    void timerCallback() override;
+    void setFootswitchState(bool isOn);  // Tremolo knob, label and bolt indicator
+    juce::Rectangle<int> getBoltArea() const { return { getWidth() / 2 - 15, 10, 30, 30 }; }
+    void showSettingsMenu();  // Right click menu for latency mode, oversampling and load display
+    void setLoadOverlayVisible(bool shouldBeVisible);
+    void setLoadLogging(bool shouldLog);
+    void setAnalyserVisible(bool shouldBeVisible);
+    void drawStaticLayer(juce::Graphics& g);  // Body, decorations, logo and knob labels
     void drawPedalDecorations(juce::Graphics& g);
     void drawShadows(juce::Graphics& g, juce::Rectangle<int> bounds);
 
+    // Rendered at the display's pixel scale, fetched again when the size or scale changes
+    juce::Image staticLayer;
+    PedalResources::ArtworkKey staticLayerKey;
+    juce::String artworkLabels;  // Pedal and knob names, part of the key
+
+    juce::SharedResourcePointer<PedalResources> resources;
     juce::SharedResourcePointer<PedalKnobLookAndFeel> lookAndFeel;
 
+    juce::int64 openStartTicks = 0;  // Until the first paint has been timed
+
     juce::Colour colour;
     juce::Slider knobs[2]; // Knobs for Drive and Level
     juce::Slider tremoloKnob; // Tremolo knob (third knob)
     juce::Label tremoloLabel; // Label for the tremolo knob
     bool tremoloKnobVisible = false; // To track if the tremolo knob should be visible
+    std::unique_ptr<LoadOverlay> loadOverlay; // Only exists while shown
+    std::unique_ptr<LevelMeters> levelMeters;
+    std::unique_ptr<AnalyserView> analyserView; // Only exists while shown
 
     DisruptionAudioProcessor& processor;
+
+    // Keep the knobs and the host parameters in sync, declared after the sliders they use
+    using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
+    std::unique_ptr<SliderAttachment> knobAttachments[2];
+    std::unique_ptr<SliderAttachment> tremoloKnobAttachment;
     
     // Member variable for button area
     juce::Rectangle<int> buttonArea;
@@ -66,9 +205,6 @@ private:
     juce::Image boltOnImage;
     juce::Image disruptionLogoImage; // Add image for disruption logo
     bool isLightOn = false; // Track the light state
-    
-    // Custom font member for the tremolo label
-    std::unique_ptr<juce::Typeface> customFont;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PedalComponent)
 };
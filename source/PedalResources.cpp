@@ -0,0 +1,69 @@
+#include "PedalResources.h"
+
+//==============================================================================
+juce::Typeface::Ptr PedalResources::getTypeface()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (typeface == nullptr)
+        typeface = juce::Typeface::createSystemTypefaceFor(BinaryData::fightingspirittbs_regular_ttf,
+                                                           BinaryData::fightingspirittbs_regular_ttfSize);
+
+    return typeface;
+}
+
+const juce::Image& PedalResources::getImage(ImageID id)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    auto& image = images[static_cast<size_t>(id)];
+
+    // Decoded directly rather than through juce::ImageCache, which drops unused images
+    // after a timeout and would decode them again for the next editor
+    if (image.isNull())
+    {
+        switch (id)
+        {
+            case ImageID::boltOff: image = juce::ImageFileFormat::loadFrom(BinaryData::boltOff_png, BinaryData::boltOff_pngSize); break;
+            case ImageID::boltOn:  image = juce::ImageFileFormat::loadFrom(BinaryData::boltOn_png, BinaryData::boltOn_pngSize); break;
+            case ImageID::logo:    image = juce::ImageFileFormat::loadFrom(BinaryData::disruptionlogo_png, BinaryData::disruptionlogo_pngSize); break;
+        }
+    }
+
+    return image;
+}
+
+const juce::Image& PedalResources::getArtwork(const ArtworkKey& key, const std::function<void(juce::Graphics&)>& draw)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    for (const auto& [cachedKey, image] : artworks)
+        if (cachedKey == key)
+            return image;
+
+    if (artworks.size() >= maxArtworks)
+        artworks.erase(artworks.begin());
+
+    juce::Image image(juce::Image::ARGB,
+                      juce::jmax(1, juce::roundToInt(key.width * key.scale)),
+                      juce::jmax(1, juce::roundToInt(key.height * key.scale)), true);
+
+    {
+        juce::Graphics g(image);
+        g.addTransform(juce::AffineTransform::scale(key.scale));
+        draw(g);
+    }
+
+    artworks.emplace_back(key, image);
+    return artworks.back().second;
+}
+
+void PedalResources::recordEditorOpen(double seconds)
+{
+    if (openStatistics.editorsOpened == 0)
+        openStatistics.firstSeconds = seconds;
+
+    ++openStatistics.editorsOpened;
+    openStatistics.lastSeconds = seconds;
+    openStatistics.totalSeconds += seconds;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Editor resources shared by every plugin instance in the process: the embedded typeface,
+// the decoded images and the pre-rendered static artwork of the pedal.
+//
+// Held through juce::SharedResourcePointer by every processor and editor, so it exists
+// once while any instance is loaded and survives editors being closed. Nothing is decoded
+// or rendered until an editor first asks for it, so only the first editor of the process
+// pays for it. Message thread only.
+class PedalResources
+{
+public:
+    enum class ImageID
+    {
+        boltOff,
+        boltOn,
+        logo
+    };
+
+    // Static layer of one editor: size, pixel scale and what is drawn into it
+    struct ArtworkKey
+    {
+        int width = 0, height = 0;
+        float scale = 1.f;  // Physical pixels per logical pixel
+        juce::uint32 colour = 0;  // Pedal colour, ARGB
+        juce::String labels;  // Pedal and knob names
+
+        bool operator==(const ArtworkKey& other) const
+        {
+            return width == other.width && height == other.height && scale == other.scale
+                && colour == other.colour && labels == other.labels;
+        }
+    };
+
+    // Editor construction up to its first paint
+    struct EditorOpenStatistics
+    {
+        int editorsOpened = 0;
+        double firstSeconds = 0.0;  // Including the decoding and rendering
+        double lastSeconds = 0.0;
+        double totalSeconds = 0.0;
+
+        double getAverageSeconds() const { return editorsOpened > 0 ? totalSeconds / editorsOpened : 0.0; }
+    };
+
+    PedalResources() = default;
+
+    juce::Typeface::Ptr getTypeface();
+    const juce::Image& getImage(ImageID id);
+
+    // The artwork for key, rendered with draw (already scaled to key.scale) the first time
+    // any editor asks for it
+    const juce::Image& getArtwork(const ArtworkKey& key, const std::function<void(juce::Graphics&)>& draw);
+
+    void recordEditorOpen(double seconds);
+    const EditorOpenStatistics& getEditorOpenStatistics() const { return openStatistics; }
+
+    static constexpr size_t maxArtworks = 8;  // Oldest is dropped beyond this
+
+private:
+    juce::Typeface::Ptr typeface;
+    std::array<juce::Image, 3> images;  // Index is ImageID
+    std::vector<std::pair<ArtworkKey, juce::Image>> artworks;
+
+    EditorOpenStatistics openStatistics;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PedalResources)
+};
@@ -13,87 +13,197 @@ DisruptionAudioProcessor::DisruptionAudioProcessor()
 #endif
     ),
 
-    Fs(44100.f),  // Initialize sample rate to a default value (will be updated in prepareToPlay)
-    inverseSampleRate(1.0f / Fs),  // Inverse of sample rate
-    Ts(1.f / Fs),  // Sampling period
-
-    // Initialize distortion-related parameters
-    distortionValue(0.5f),  // Initialize distortion value (drive knob)
-    C1(47.e-9f),
-    R1(Ts / (2.f * C1)),
-    R3(4.7e3f),
-    R4(1.e6f),
-    potDis(0.f),
-    Rp(0.0f),
-    G_distortion(0.0f),
-    Gb(0.0f),
-    Gi(0.0f),
-    Gx1(0.0f),
-    x1(0.0f),
-
-    // Initialize clipping-related parameters
-    levelValue(0.5f),       // Initialize level value
-    C2(1.e-9f),
-    R5(10.e3f),
-    Vd(0.0f),
-    thr(0.0000001f),
-    R2(0.0f),
-    x2(0.0f),
-    G_clipping(0.0f),
-    potLev(0.f),        // Initialize level knob state
-
-    // Initialize effect control values
-    effectOn(true),
-
-    // Initialize tremolo parameters
-    tremoloRate(2.0f),
-    tremoloOn(false),
-    tremoloPhase(0.0),
-    tremoloDepth(0.3f),
-
-    // Initialize chorus effect
-    chorus(),
+    parameters(*this, nullptr, "Parameters", createParameterLayout()),
+
+    requestedClippingMode(ClippingMode::lookupTable),
+    simdKernelEnabled(true),
 
      //Initialize high-pass and low-pass filters
     /*highPassFilter(),*/
     iir()
 {
-    // Initialize lastSample vector for channel-based processing
-    lastSample.resize(getTotalNumInputChannels(), 0.0f);
-
-    // Prepare the chorus effect with default values
-    chorus.setRate(0.5f);
-    chorus.setDepth(0.2f);
-    chorus.setCentreDelay(3.0f);
-    chorus.setFeedback(0.2f);
-    chorus.setMix(0.3f);
+    // The audio thread reads the parameters through their raw values
+    distortionValue = parameters.getRawParameterValue(ParameterIDs::drive);
+    levelValue = parameters.getRawParameterValue(ParameterIDs::level);
+    tremoloRate = parameters.getRawParameterValue(ParameterIDs::tremoloRate);
+    tremoloOn = parameters.getRawParameterValue(ParameterIDs::tremoloOn);
+    tremoloDepth = parameters.getRawParameterValue(ParameterIDs::tremoloDepth);
+    tremoloShape = parameters.getRawParameterValue(ParameterIDs::tremoloShape);
+    tremoloSpread = parameters.getRawParameterValue(ParameterIDs::tremoloSpread);
+    tempoSync = parameters.getRawParameterValue(ParameterIDs::tempoSync);
+    syncDivision = parameters.getRawParameterValue(ParameterIDs::syncDivision);
+    bypassValue = parameters.getRawParameterValue(ParameterIDs::bypass);
+    chorusDepth = parameters.getRawParameterValue(ParameterIDs::chorusDepth);
+    chorusMix = parameters.getRawParameterValue(ParameterIDs::chorusMix);
+
+    chorusLFO.setShape(LFO::Shape::sine);
+    chorusLFO.setFrequency(chorusRate);
+    chorus.setFeedback(chorusFeedback);
+
+    circuit.setStageListener(this);
+
+    startTimer(latencyPollMs);
 }
 
 // Destructor definition
 DisruptionAudioProcessor::~DisruptionAudioProcessor()
 {
+    stopTimer();
+}
+
+void DisruptionAudioProcessor::timerCallback()
+{
+    // Reporting latency notifies listeners under a lock, so chain switches on the audio
+    // thread leave it to this poll
+    const int latency = pendingLatency.load();
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+// Note divisions the tremolo can sync to, in quarter notes per cycle
+struct SyncDivision
+{
+    const char* name;
+    double quarterNotes;
+};
+
+static constexpr SyncDivision syncDivisions[] = {
+    { "1/1", 4.0 }, { "1/2", 2.0 }, { "1/4", 1.0 }, { "1/8", 0.5 }, { "1/16", 0.25 },
+    { "1/2 T", 4.0 / 3.0 }, { "1/4 T", 2.0 / 3.0 }, { "1/8 T", 1.0 / 3.0 },
+    { "1/2 D", 3.0 }, { "1/4 D", 1.5 }, { "1/8 D", 0.75 }
+};
+
+juce::AudioProcessorValueTreeState::ParameterLayout DisruptionAudioProcessor::createParameterLayout()
+{
+    using Range = juce::NormalisableRange<float>;
+
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::drive, 1 }, "Drive", Range(0.f, 1.f), 0.5f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::level, 1 }, "Level", Range(0.f, 1.f), 0.5f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::tremoloRate, 1 }, "Tremolo Rate",
+                                                           Range(0.1f, 10.f), 2.f,
+                                                           juce::AudioParameterFloatAttributes().withLabel("Hz")));
+    layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID { ParameterIDs::tremoloOn, 1 }, "Disruption", false));
+
+    // Depth 0.5 swings the gain between 1 and 0
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::tremoloDepth, 1 }, "Tremolo Depth",
+                                                           Range(0.f, 0.5f), 0.3f));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { ParameterIDs::tremoloShape, 1 }, "Tremolo Shape",
+                                                            juce::StringArray { "Sine", "Triangle", "Square" }, 2));
+
+    // Half a cycle puts the two sides of a stereo pair in anti-phase, a panning tremolo
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::tremoloSpread, 1 }, "Tremolo Spread",
+                                                           Range(0.f, 0.5f), 0.f));
+
+    juce::StringArray divisionNames;
+
+    for (const auto& division : syncDivisions)
+        divisionNames.add(division.name);
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID { ParameterIDs::tempoSync, 1 }, "Tempo Sync", false));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { ParameterIDs::syncDivision, 1 }, "Sync Division",
+                                                            divisionNames, 2));
+    layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID { ParameterIDs::bypass, 1 }, "Bypass", false));
+
+    // Depth 1 sweeps the chorus delay by 10 ms either side of its 3 ms centre
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::chorusDepth, 1 }, "Chorus Depth",
+                                                           Range(0.f, 1.f), 0.2f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { ParameterIDs::chorusMix, 1 }, "Chorus Mix",
+                                                           Range(0.f, 1.f), 0.3f));
+    return layout;
+}
+
+void DisruptionAudioProcessor::setParameterValue(const juce::String& parameterID, float newValue)
+{
+    auto* parameter = parameters.getParameter(parameterID);
+    jassert(parameter != nullptr);
+
+    parameter->beginChangeGesture();
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(newValue));
+    parameter->endChangeGesture();
 }
 
 //==============================================================================
 void DisruptionAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    Fs = static_cast<float>(sampleRate);
-    inverseSampleRate = 1.0f / Fs;          // Calculate and store the inverse of the sample rate
-    Ts = inverseSampleRate;
-    updateDistortionCoefficients();
-    updateClippingCoefficients();
+    const auto numChannels = static_cast<size_t>(getTotalNumInputChannels());
+    hostSampleRate = sampleRate;
+    preparedBlockSize = samplesPerBlock;
+
+    // Build the oversamplers, and the circuit's coefficients and diode table for every
+    // factor up front, so the audio thread can switch between them without allocating or
+    // rebuilding anything
+    for (int order = 1; order < numOversamplingFactors; ++order)
+    {
+        oversamplers[order] = std::make_unique<juce::dsp::Oversampling<float>>(
+            numChannels, order, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+        oversamplers[order]->initProcessing(static_cast<size_t>(samplesPerBlock));
+
+        linearPhaseOversamplers[order] = std::make_unique<juce::dsp::Oversampling<float>>(
+            numChannels, order, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true, true);
+        linearPhaseOversamplers[order]->initProcessing(static_cast<size_t>(samplesPerBlock));
+    }
+
+    const auto maxCircuitBlockSize = static_cast<size_t>(samplesPerBlock << (numOversamplingFactors - 1));
+    circuit.prepare(sampleRate, numOversamplingFactors, static_cast<int>(numChannels), static_cast<int>(maxCircuitBlockSize));
+
+    // Start at the current knob positions instead of ramping up from the last session
+    driveSmoother.setCurrentAndTargetValue(distortionValue->load());
+    levelSmoother.setCurrentAndTargetValue(levelValue->load());
+
+    // Dry path for bypass, delayed by up to the largest oversampling latency
+    int maxLatency = 0;
+
+    for (int order = 1; order < numOversamplingFactors; ++order)
+        maxLatency = juce::jmax(maxLatency,
+                                juce::roundToInt(oversamplers[order]->getLatencyInSamples()),
+                                juce::roundToInt(linearPhaseOversamplers[order]->getLatencyInSamples()));
+
+    dryDelay.setMaximumDelayInSamples(maxLatency);
+    dryDelay.prepare({ sampleRate, static_cast<juce::uint32>(samplesPerBlock), static_cast<juce::uint32>(numChannels) });
+
+    bypassFade.reset(sampleRate, bypassFadeMs * 0.001);
+    bypassFade.setCurrentAndTargetValue(bypassValue->load() >= 0.5f ? 1.f : 0.f);
+
+    analyser.prepare(sampleRate);
+
+    silenceHoldSamples = juce::roundToInt(sampleRate * silenceHoldSeconds);
+    silentSamples = 0;
+    lastOutputPeak = 0.f;
+    processingSuspended = false;
+
+    const auto chain = getChain(getLatencyMode(), requestedOversampling.load());
+    activeOversampling = -1;
+    setActiveOversampling(chain.order, chain.linearPhase);
+    setLatencySamples(pendingLatency.load());  // Known to the host before the first block
+
+    chainFade.reset(sampleRate, chainFadeMs * 0.001);
+    chainFade.setCurrentAndTargetValue(1.f);
+    chainFadeSamples = static_cast<int>(std::floor(chainFadeMs * 0.001 * sampleRate));  // Steps of the chainFade ramp
+    chainFadeOutSamples = 0;
    
-    // Resize lastSample to match input channels
-    lastSample.resize(getTotalNumInputChannels(), 0.0f);
+    // Every other buffer the audio thread writes to, in one zeroed arena. The circuit
+    // keeps its state in its own
+    arena.build([&] (DSPArena& memory)
+    {
+        // Knob ramps, sized for the largest oversampled block
+        driveRamp = memory.allocate<float>(maxCircuitBlockSize);
+        levelRamp = memory.allocate<float>(maxCircuitBlockSize);
+
+        tremoloDepths = memory.allocate<float>(static_cast<size_t>(samplesPerBlock));
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+            dryChannels[channel] = memory.allocate<float>(static_cast<size_t>(samplesPerBlock)).data();
+    });
+
+    dryBuffer.setDataToReferTo(dryChannels.data(), static_cast<int>(numChannels), samplesPerBlock);
 
-    // Initialize or resize x1State for each channel (same for x2State if needed)
-    x1State.resize(getTotalNumInputChannels(), 0.0f);
-    x2State.resize(getTotalNumInputChannels(), 0.0f);  // If needed for clipping
     // Create a single ProcessSpec instance to use for all DSP initialization
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 2;  // Ensure that stereo is supported in the DSP setup
+    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
+    spec.numChannels = static_cast<juce::uint32>(numChannels);  // Every channel of the layout
 
 
      //Prepare the low - pass filter
@@ -105,11 +215,75 @@ void DisruptionAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBl
     auto highPassCoefficients = juce::IIRCoefficients::makeHighPass(sampleRate, cutoffFrequency);
     highPassFilter.setCoefficients(highPassCoefficients); */
 
-    // Prepare the chorus effect
-    chorus.prepare(spec);
+    // Initialize tremolo and chorus parameters
+    tremoloLFO.prepare(sampleRate, samplesPerBlock, static_cast<int>(numChannels));
+    chorusLFO.prepare(sampleRate, samplesPerBlock, static_cast<int>(numChannels));
+    chorus.setDepth(chorusDepth->load());
+    chorus.setMix(isTremoloOn() ? chorusMix->load() : 0.f);
+    chorus.prepare(sampleRate, samplesPerBlock, static_cast<int>(numChannels));
+    tremoloDepthSmoother.reset(sampleRate, parameterRampMs * 0.001);
+    tremoloDepthSmoother.setCurrentAndTargetValue(isTremoloOn() ? tremoloDepth->load() : 0.f);
+
+    // A processor can be prepared again for another stream, e.g. the next file in a batch
+    // render, which must not hear the end of the previous one
+    resetProcessingState();
+}
 
-    // Initialize tremolo parameters
-    tremoloPhase = 0.0;
+void DisruptionAudioProcessor::resetParameterSmoothing(double circuitRate)
+{
+    // reset() finishes any ramp in progress, which is inaudible next to the factor switch
+    driveSmoother.reset(circuitRate, parameterRampMs * 0.001);
+    levelSmoother.reset(circuitRate, parameterRampMs * 0.001);
+    circuit.setDrive(driveSmoother.getCurrentValue());
+    circuit.setLevel(levelSmoother.getCurrentValue());
+}
+
+DisruptionAudioProcessor::CircuitChain DisruptionAudioProcessor::getChain(LatencyMode mode, int requestedOrder) const
+{
+    switch (mode)
+    {
+        case LatencyMode::zeroLatency:  return { 0, false };
+        case LatencyMode::highQuality:  return { juce::jmax(1, requestedOrder), true };
+        case LatencyMode::lowLatency:   break;
+    }
+
+    return { requestedOrder, false };
+}
+
+int DisruptionAudioProcessor::getLatencyForMode(LatencyMode mode) const
+{
+    const auto chain = getChain(mode, requestedOversampling.load());
+    const auto& chainOversamplers = chain.linearPhase ? linearPhaseOversamplers : oversamplers;
+
+    if (chain.order == 0 || chainOversamplers[chain.order] == nullptr)
+        return 0;
+
+    return juce::roundToInt(chainOversamplers[chain.order]->getLatencyInSamples());
+}
+
+void DisruptionAudioProcessor::setActiveOversampling(int order, bool linearPhase)
+{
+    if (order == activeOversampling && linearPhase == activeLinearPhase)
+        return;
+
+    activeOversampling = order;
+    activeLinearPhase = linearPhase;
+    circuit.setOversamplingOrder(order);
+    resetParameterSmoothing(hostSampleRate * (1 << order));
+
+    activeOversampler = order > 0 ? (linearPhase ? linearPhaseOversamplers : oversamplers)[order].get() : nullptr;
+
+    int latency = 0;
+
+    if (activeOversampler != nullptr)
+    {
+        activeOversampler->reset();
+        latency = juce::roundToInt(activeOversampler->getLatencyInSamples());
+    }
+
+    // The host hears about it from timerCallback or prepareToPlay
+    pendingLatency = latency;
+    dryDelay.setDelay(static_cast<float>(latency));
 }
 
 //==============================================================================
@@ -120,86 +294,517 @@ void DisruptionAudioProcessor::releaseResources()
 
 bool DisruptionAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
+    // Any layout up to maxChannels, every channel runs its own circuit. The output matches
+    // the input, apart from mono in to stereo out, where the mono pedal plays on both sides,
+    // and stereo in to mono out, where it runs on the mix of the two
+    const auto& input = layouts.getMainInputChannelSet();
+    const auto& output = layouts.getMainOutputChannelSet();
 
-    if (layouts.getMainInputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainInputChannelSet() != juce::AudioChannelSet::stereo())
+    if (input.isDisabled() || input.size() > maxChannels)
         return false;
 
-    return true;
+    const auto mono = juce::AudioChannelSet::mono();
+    const auto stereo = juce::AudioChannelSet::stereo();
+
+    return output == input || (input == mono && output == stereo) || (input == stereo && output == mono);
 }
 
 
 void DisruptionAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels = buffer.getNumChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+   #if DISRUPTION_AUDIO_THREAD_CHECKS
+    const AudioThreadGuard::Scope audioThread;  // Any allocation or lock from here on asserts
+   #endif
+
+    juce::ignoreUnused(midiMessages);
+
+    const int numInputChannels = getTotalNumInputChannels();
+    const int numOutputChannels = getTotalNumOutputChannels();
+    const int numSamples = buffer.getNumSamples();
+
+    // Stereo into a mono output runs the pedal on the mix of both sides
+    if (numInputChannels > numOutputChannels)
+    {
+        for (int channel = 1; channel < numInputChannels; ++channel)
+            buffer.addFrom(0, 0, buffer, channel, 0, numSamples);
+
+        buffer.applyGain(0, 0, numSamples, 1.f / static_cast<float>(numInputChannels));
+    }
+
+    // Hosts may send more samples than announced in prepareToPlay, every buffer of the
+    // pedal is sized for the announced block, so larger blocks run in parts. A part also
+    // ends where a chain fade-out does, so the new chain fades in within the same block
+    const int numChannels = juce::jmin(numInputChannels, numOutputChannels);
+
+    jassert(preparedBlockSize > 0);  // processBlock before prepareToPlay
+    const int partSize = juce::jmax(1, preparedBlockSize);
+
+    for (int start = 0; start < numSamples;)
+    {
+        const int partLength = juce::jmax(1, juce::jmin(partSize, numSamples - start, updateChain()));
+
+        if (partLength == numSamples)
+        {
+            processChannels(buffer, numChannels, 0);
+        }
+        else
+        {
+            // Refers to the host's channels, no allocation up to 32 channels
+            juce::AudioBuffer<float> part(buffer.getArrayOfWritePointers(), numChannels, start, partLength);
+            processChannels(part, numChannels, start);
+        }
+
+        chainFadeOutSamples = juce::jmax(0, chainFadeOutSamples - partLength);
+        start += partLength;
+    }
+
+    // A mono input feeding a stereo output plays on both sides
+    for (int channel = numChannels; channel < numOutputChannels; ++channel)
+        buffer.copyFrom(channel, 0, buffer, 0, 0, numSamples);
+}
+
+int DisruptionAudioProcessor::updateChain()
+{
+    // A new latency mode or oversampling factor is switched to once the output has faded
+    // out, or straight away while nothing is processed and the dry path is not heard. The
+    // switch moves the dry delay too, so a bypassed output fades like a processed one
+    const auto requestedChain = getChain(getLatencyMode(), requestedOversampling.load());
+    bool chainChanged = requestedChain.order != activeOversampling || requestedChain.linearPhase != activeLinearPhase;
+    const bool dryAudible = bypassValue->load() >= 0.5f || bypassFade.getCurrentValue() > 0.f;
+
+    if (chainChanged && ((processingSuspended && ! dryAudible) || (! chainFade.isSmoothing() && chainFade.getCurrentValue() <= 0.f)))
+    {
+        setActiveOversampling(requestedChain.order, requestedChain.linearPhase);
+        resetProcessingState();
+        chainChanged = false;
+    }
+
+    if (! chainChanged)
+    {
+        chainFade.setTargetValue(1.f);
+        return std::numeric_limits<int>::max();
+    }
+
+    // Every new fade-out takes the full ramp, also from part way into a fade-in
+    if (chainFade.getTargetValue() > 0.f)
+    {
+        chainFade.setTargetValue(0.f);
+        chainFadeOutSamples = chainFadeSamples;
+    }
+
+    return chainFadeOutSamples;
+}
+
+void DisruptionAudioProcessor::processChannels(juce::AudioBuffer<float>& buffer, int numChannels, int sampleOffset)
+{
+    // Stage timing runs for offline tools and while the load monitor has a consumer
+   #if DISRUPTION_INSTRUMENTATION
+    const bool instrumented = loadMonitor.isEnabled();
+    const auto blockStartTicks = instrumented ? juce::Time::getHighResolutionTicks() : 0;
+    LoadMonitor::BlockReport report;
+    timingStages = instrumented || stageTimings != nullptr;
+   #else
+    timingStages = stageTimings != nullptr;
+   #endif
     
-    // Set knob values for distortion and clipping
-    setDistortionKnob(distortionValue);  // Update the distortion knob value
-    setClippingKnob(levelValue);
+    // Pick up a new solver at the block boundary
+    circuit.setClippingMode(requestedClippingMode.load());
+    circuit.setSIMDEnabled(simdKernelEnabled.load());
+
+    // Ramp towards the latest knob positions, the circuit advances the ramps per sample.
+    // Hosts deliver automation at block boundaries, so the ramp starts at the sample where
+    // the new value takes effect
+    driveSmoother.setTargetValue(distortionValue->load());
+    levelSmoother.setTargetValue(levelValue->load());
 
-    // Clear any unused output channels
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear(i, 0, buffer.getNumSamples());
+    const bool tremoloActive = isTremoloOn();
+    const float rate = tremoloRate->load();
+    const bool bypassed = bypassValue->load() >= 0.5f;
 
     auto numSamples = buffer.getNumSamples();
-    auto sampleRate = getSampleRate();
 
-    // Process each channel
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    // Levels for the editor's meters, only measured while it shows them
+    const bool metering = meterFifo.isActive();
+    MeterBlock meter;
+
+    if (metering)
+        measureLevels(buffer, numChannels, meter.inputPeak, meter.inputMeanSquare);
+
+    circuit.setDriveLevelsEnabled(metering);
+
+    tremoloLFO.setFrequency(rate);
+    tremoloLFO.setShape(static_cast<LFO::Shape>(juce::roundToInt(tremoloShape->load())));
+    updateTremoloSpread(numChannels);
+    tremoloDepthSmoother.setTargetValue(tremoloActive ? tremoloDepth->load() : 0.f);
+    chorus.setDepth(chorusDepth->load());
+    chorus.setMix(tremoloActive ? chorusMix->load() : 0.f);
+    updateTempoSync(sampleOffset);
+
+    // The dry signal always runs through the latency delay, so a bypass fade can start at any block
+    bypassFade.setTargetValue(bypassed ? 1.f : 0.f);
+    delayDrySignal(buffer, numChannels);
+
+    if (bypassed && ! bypassFade.isSmoothing())
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        const float* inputChannelData = buffer.getReadPointer(channel < totalNumInputChannels ? channel : 0);
+        // Fully bypassed, none of the processing runs
+        for (int channel = 0; channel < numChannels; ++channel)
+            buffer.copyFrom(channel, 0, dryBuffer, channel, 0, numSamples);
 
-        for (int n = 0; n < numSamples; ++n)
+        if (chainFade.isSmoothing())
+            chainFade.applyGain(buffer, numSamples);
+
+        tremoloLFO.skip(numSamples);
+        chorusLFO.skip(numSamples);
+        processingSuspended = true;
+
+        if (metering)
+            pushMeterBlock(meter, buffer, numChannels);
+
+        if (analyser.isEnabled())
+            analyser.push(juce::dsp::AudioBlock<const float>(buffer).getSubsetChannelBlock(0, static_cast<size_t>(numChannels)));
+
+       #if DISRUPTION_INSTRUMENTATION
+        if (instrumented)
+            pushLoadReport(report, blockStartTicks, numSamples);
+       #endif
+
+        return;
+    }
+
+    if (updateSilenceDetector(buffer, numChannels))
+    {
+        // Input and circuit are silent, so the output of every stage is too. Only the
+        // LFOs keep running so they stay in time
+        for (int channel = 0; channel < numChannels; ++channel)
+            buffer.clear(channel, 0, numSamples);
+
+        tremoloLFO.skip(numSamples);
+        chorusLFO.skip(numSamples);
+        tremoloDepthSmoother.skip(numSamples);
+
+        processingSuspended = true;
+    }
+    else
+    {
+        // Every state decayed to (or was held at) silence while suspended, so starting
+        // again from cleared state is seamless
+        if (processingSuspended)
         {
-            // Get the input sample and use the last sample for this channel
-            float inputSample = inputChannelData[n];
+            resetProcessingState();
+            processingSuspended = false;
+        }
 
-            // Apply distortion
-            float distortedSample = processDistortionSample(inputSample, x1State[channel]);
+        if (timingStages)
+            stageStartTicks = juce::Time::getHighResolutionTicks();
 
-            // Apply clipping
-            float clippedSample = processClippingSample(distortedSample, x2State[channel]);
+        // One view of the processed channels for every stage. Distortion and clipping run at
+        // the circuit rate, everything after at the host rate
+        auto block = juce::dsp::AudioBlock<float>(buffer).getSubsetChannelBlock(0, static_cast<size_t>(numChannels));
+        const juce::dsp::ProcessContextReplacing<float> context(block);
 
-            // Apply tremolo if enabled
-            if (tremoloOn)
+        if (activeOversampler != nullptr)
+        {
+            auto oversampledBlock = activeOversampler->processSamplesUp(block);
+            markStageEnd(StageTimings::oversampling);
+            processCircuit(oversampledBlock);
+            activeOversampler->processSamplesDown(block);
+            markStageEnd(StageTimings::oversampling);
+        }
+        else
+        {
+            processCircuit(block);
+        }
+
+        // Apply tremolo. Switching it on or off ramps the depth, so neither clicks
+        if (tremoloDepthSmoother.isSmoothing() || tremoloDepthSmoother.getTargetValue() > 0.f)
+        {
+            tremoloLFO.process(numSamples);
+
+            float* depths = tremoloDepths.data();
+
+            if (tremoloDepthSmoother.isSmoothing())
+            {
+                for (int n = 0; n < numSamples; ++n)
+                    depths[n] = tremoloDepthSmoother.getNextValue();
+            }
+            else
+            {
+                std::fill(depths, depths + numSamples, tremoloDepthSmoother.getTargetValue());
+            }
+
+            for (int channel = 0; channel < numChannels; ++channel)
             {
-                // Simple tremolo effect using LFO (Low-Frequency Oscillator)
-                float lfo = std::sin(tremoloPhase) >= 0 ? 1.0f : -1.0f;  // Square wave
-                float tremoloMod = 1.0f - (tremoloDepth * (1.0f - lfo));
-                clippedSample *= tremoloMod;
+                auto* channelData = buffer.getWritePointer(channel);
+                const float* lfo = tremoloLFO.getValues(channel);
+
+                for (int n = 0; n < numSamples; ++n)
+                    channelData[n] *= 1.0f - depths[n] * (1.0f - lfo[n]);
+            }
+        }
+        else
+        {
+            tremoloLFO.skip(numSamples);  // Keep running, so it stays in time when switched on
+        }
+
+        markStageEnd(StageTimings::tremolo);
+
+        // Apply chorus. It follows the tremolo switch, ramping its mix like the tremolo depth
+        if (chorus.isActive())
+        {
+            chorusLFO.process(numSamples);
+            chorus.process(block, chorusLFO);
+        }
+        else
+        {
+            chorusLFO.skip(numSamples);
+        }
+
+        markStageEnd(StageTimings::chorus);
+
+        // Clean high frequencies (apply low - pass filter at the end). Only needed to mask
+        // aliasing at the host rate, the oversampling filters already band-limit the clipper
+        if (activeOversampling == 0)
+            iir.process(context);
+
+        markStageEnd(StageTimings::postFilter);
+
+        lastOutputPeak = 0.f;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            lastOutputPeak = juce::jmax(lastOutputPeak, buffer.getMagnitude(channel, 0, numSamples));
+
+        const auto& blockStatistics = circuit.getSolverStatistics();
+
+       #if DISRUPTION_INSTRUMENTATION
+        if (instrumented)
+        {
+            report.solverSamples = static_cast<juce::uint32>(blockStatistics.samples);
+            report.solverIterations = static_cast<juce::uint32>(blockStatistics.iterations);
+            report.denormalEvents = circuit.flushDenormals();
+        }
+       #endif
+
+        publishSolverStatistics(blockStatistics);
+        circuit.clearSolverStatistics();
+
+        if (metering)
+        {
+            const auto& driveLevels = circuit.getDriveLevels();
+            meter.opAmpPeak = driveLevels.opAmpPeak;
+            meter.railedFraction = static_cast<float>(driveLevels.getRailedFraction());
+            meter.diodePeak = driveLevels.diodePeak;
+            circuit.clearDriveLevels();
+        }
 
-                // Update the tremolo phase
-                tremoloPhase += 2.0 * juce::MathConstants<double>::pi * tremoloRate * (1.0 / sampleRate);
+        if (stageTimings != nullptr)
+            for (size_t stage = 0; stage < blockTimings.seconds.size(); ++stage)
+                stageTimings->seconds[stage] += blockTimings.seconds[stage];
+    }
+
+    // Crossfade between the processed and the dry signal while bypass changes
+    if (bypassFade.isSmoothing())
+    {
+        for (int n = 0; n < numSamples; ++n)
+        {
+            const float dryGain = bypassFade.getNextValue();
 
-                // Keep phase in bounds [0, 2π]
-                if (tremoloPhase >= 2.0 * juce::MathConstants<double>::pi)
-                    tremoloPhase -= 2.0 * juce::MathConstants<double>::pi;
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* channelData = buffer.getWritePointer(channel);
+                channelData[n] += dryGain * (dryBuffer.getSample(channel, n) - channelData[n]);
             }
+        }
+    }
+
+    // Chain switch fade, over the dry signal as well since its delay changes with the chain
+    if (chainFade.isSmoothing())
+        chainFade.applyGain(buffer, numSamples);
 
-            // Store the current sample as the last sample for the next loop
-            lastSample[channel] = clippedSample;
+    if (metering)
+        pushMeterBlock(meter, buffer, numChannels);
 
-            // Apply the processed sample to the buffer
-            channelData[n] = clippedSample;
+    if (analyser.isEnabled())
+        analyser.push(juce::dsp::AudioBlock<const float>(buffer).getSubsetChannelBlock(0, static_cast<size_t>(numChannels)));
+
+   #if DISRUPTION_INSTRUMENTATION
+    if (instrumented)
+        pushLoadReport(report, blockStartTicks, numSamples);
+   #endif
+
+    blockTimings.clear();
+}
+
+void DisruptionAudioProcessor::measureLevels(const juce::AudioBuffer<float>& buffer, int numChannels, float& peak, float& meanSquare)
+{
+    const int numSamples = buffer.getNumSamples();
+    peak = 0.f;
+    meanSquare = 0.f;
+
+    if (numChannels == 0 || numSamples == 0)
+        return;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        peak = juce::jmax(peak, buffer.getMagnitude(channel, 0, numSamples));
+        meanSquare += juce::square(buffer.getRMSLevel(channel, 0, numSamples));
+    }
+
+    meanSquare /= static_cast<float>(numChannels);
+}
+
+void DisruptionAudioProcessor::pushMeterBlock(MeterBlock& meter, const juce::AudioBuffer<float>& buffer, int numChannels)
+{
+    measureLevels(buffer, numChannels, meter.outputPeak, meter.outputMeanSquare);
+    meter.numSamples = buffer.getNumSamples();
+    meterFifo.push(meter);
+}
+
+#if DISRUPTION_INSTRUMENTATION
+void DisruptionAudioProcessor::pushLoadReport(LoadMonitor::BlockReport& report, juce::int64 blockStartTicks, int numSamples)
+{
+    report.seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - blockStartTicks);
+    report.stageSeconds = blockTimings.seconds;
+    report.sampleRate = hostSampleRate;
+    report.numSamples = numSamples;
+    loadMonitor.push(report);
+}
+#endif
+
+void DisruptionAudioProcessor::updateTremoloSpread(int numChannels)
+{
+    // First channel at the shared phase, last one the spread behind it
+    const float spread = tremoloSpread->load();
+
+    for (int channel = 1; channel < numChannels; ++channel)
+        tremoloLFO.setChannelPhaseOffset(channel, spread * static_cast<float>(channel) / static_cast<float>(numChannels - 1));
+}
+
+void DisruptionAudioProcessor::updateTempoSync(int sampleOffset)
+{
+    juce::Optional<juce::AudioPlayHead::PositionInfo> position;
+
+    if (auto* playHead = getPlayHead())
+        position = playHead->getPosition();
+
+    const bool playing = position.hasValue() && position->getIsPlaying();
+    const bool synced = tempoSync->load() >= 0.5f;
+
+    if (position.hasValue())
+        if (auto bpm = position->getBpm())
+            hostBpm = juce::jlimit(20.0, 999.0, *bpm);
+
+    if (! synced)
+    {
+        chorusLFO.setFrequency(chorusRate);
+        return;
+    }
+
+    const auto& division = syncDivisions[juce::jlimit(0, static_cast<int>(std::size(syncDivisions)) - 1,
+                                                      juce::roundToInt(syncDivision->load()))];
+    const double beatsPerSecond = hostBpm / 60.0;
+    tremoloLFO.setFrequency(static_cast<float>(beatsPerSecond / division.quarterNotes));
+
+    // Chorus sweeps once per bar
+    double quarterNotesPerBar = 4.0;
+
+    if (position.hasValue())
+        if (auto timeSignature = position->getTimeSignature())
+            quarterNotesPerBar = 4.0 * timeSignature->numerator / juce::jmax(1, timeSignature->denominator);
+
+    chorusLFO.setFrequency(static_cast<float>(beatsPerSecond / quarterNotesPerBar));
+
+    // Locked to the song position while playing, free running at the host tempo otherwise
+    if (playing)
+    {
+        if (auto ppq = position->getPpqPosition())
+        {
+            const double blockPpq = *ppq + sampleOffset * beatsPerSecond / hostSampleRate;
+            tremoloLFO.setPhase(blockPpq / division.quarterNotes);
+            chorusLFO.setPhase(blockPpq / quarterNotesPerBar);
         }
     }
+}
+
+void DisruptionAudioProcessor::delayDrySignal(const juce::AudioBuffer<float>& buffer, int numChannels)
+{
+    jassert(buffer.getNumSamples() <= dryBuffer.getNumSamples());
 
-    // Apply Chorus DSP effect if enabled (tremoloOn could be checked if needed)
-    if (tremoloOn)
+    for (int channel = 0; channel < numChannels; ++channel)
     {
-        juce::dsp::AudioBlock<float> block(buffer);
-        chorus.process(juce::dsp::ProcessContextReplacing<float>(block));
+        const auto* input = buffer.getReadPointer(channel);
+        auto* dry = dryBuffer.getWritePointer(channel);
+
+        for (int n = 0; n < buffer.getNumSamples(); ++n)
+        {
+            dryDelay.pushSample(channel, input[n]);
+            dry[n] = dryDelay.popSample(channel);
+        }
     }
+}
+
+bool DisruptionAudioProcessor::updateSilenceDetector(const juce::AudioBuffer<float>& buffer, int numChannels)
+{
+    float inputPeak = 0.f;
 
-    //Clean high frequencies(apply low - pass filter at the end)
-    juce::dsp::AudioBlock<float> block(buffer);
-    iir.process(juce::dsp::ProcessContextReplacing<float>(block));
+    for (int channel = 0; channel < numChannels; ++channel)
+        inputPeak = juce::jmax(inputPeak, buffer.getMagnitude(channel, 0, buffer.getNumSamples()));
+
+    // The level knob can hide a circuit that is still ringing, so check the diode voltage too
+    const float circuitPeak = circuit.getPeakDiodeVoltage();
+
+    if (inputPeak < silenceThreshold && circuitPeak < silenceThreshold && lastOutputPeak < silenceThreshold)
+        silentSamples = juce::jmin(silentSamples + buffer.getNumSamples(), silenceHoldSamples);
+    else
+        silentSamples = 0;
+
+    return silentSamples >= silenceHoldSamples;
+}
+
+void DisruptionAudioProcessor::resetProcessingState()
+{
+    circuit.reset();
+
+    if (activeOversampler != nullptr)
+        activeOversampler->reset();
+
+    chorus.reset();
+    iir.reset();
+
+    silentSamples = 0;
+    lastOutputPeak = 0.f;
+}
+
+void DisruptionAudioProcessor::processCircuit(juce::dsp::AudioBlock<float>& block)
+{
+    const auto numSamples = block.getNumSamples();
+    jassert(numSamples <= driveRamp.size());
+
+    // Knob ramps are rendered once per block, so every channel and lane group sees the
+    // same coefficients at the same sample
+    const bool driveRamping = driveSmoother.isSmoothing();
+    const bool levelRamping = levelSmoother.isSmoothing();
+
+    if (driveRamping)
+        for (size_t n = 0; n < numSamples; ++n)
+            driveRamp[n] = driveSmoother.getNextValue();
+
+    if (levelRamping)
+        for (size_t n = 0; n < numSamples; ++n)
+            levelRamp[n] = levelSmoother.getNextValue();
+
+    circuit.process(block, driveRamping ? driveRamp.data() : nullptr, levelRamping ? levelRamp.data() : nullptr);
+}
+
+void DisruptionAudioProcessor::markStageEnd(StageTimings::Stage stage)
+{
+    if (! timingStages)
+        return;
+
+    const auto now = juce::Time::getHighResolutionTicks();
+    blockTimings.seconds[stage] += juce::Time::highResolutionTicksToSeconds(now - stageStartTicks);
+    stageStartTicks = now;
 }
 
 //==============================================================================
@@ -214,6 +819,11 @@ bool DisruptionAudioProcessor::hasEditor() const
     return true;
 }
 
+juce::AudioProcessorParameter* DisruptionAudioProcessor::getBypassParameter() const
+{
+    return parameters.getParameter(ParameterIDs::bypass);
+}
+
 //==============================================================================
 const juce::String DisruptionAudioProcessor::getName() const
 {
@@ -227,20 +837,52 @@ bool DisruptionAudioProcessor::isMidiEffect() const { return false; }
 double DisruptionAudioProcessor::getTailLengthSeconds() const { return 0.0; }
 int DisruptionAudioProcessor::getNumPrograms() { return 1; }
 int DisruptionAudioProcessor::getCurrentProgram() { return 0; }
-void DisruptionAudioProcessor::setCurrentProgram(int index) {}
-const juce::String DisruptionAudioProcessor::getProgramName(int index) { return {}; }
-void DisruptionAudioProcessor::changeProgramName(int index, const juce::String& newName) {}
+void DisruptionAudioProcessor::setCurrentProgram(int) {}
+const juce::String DisruptionAudioProcessor::getProgramName(int) { return {}; }
+void DisruptionAudioProcessor::changeProgramName(int, const juce::String&) {}
 
 //==============================================================================
+// Saved state: a magic number and version, then the parameter tree in JUCE's binary
+// ValueTree format, which loads without the XML parse of copyXmlToBinary
+static constexpr int stateMagic = 0x50525344;  // "DSRP"
+
+// Version 0 was written before the parameters existed: tremolo rate and tremolo on only
+static constexpr int legacyStateSize = sizeof(float) + 1;
+
 void DisruptionAudioProcessor::getStateInformation(juce::MemoryBlock& destData) {
-    juce::MemoryOutputStream stream(destData, true);
-    stream.writeFloat(tremoloRate);
-    stream.writeBool(tremoloOn);
+    auto state = parameters.copyState();
+    state.setProperty("oversampling", requestedOversampling.load(), nullptr);
+    state.setProperty("latencyMode", requestedLatencyMode.load(), nullptr);
+    state.setProperty("solver", static_cast<int>(requestedClippingMode.load()), nullptr);
+
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(stateMagic);
+    stream.writeInt(currentStateVersion);
+    state.writeToStream(stream);
 }
 void DisruptionAudioProcessor::setStateInformation(const void* data, int sizeInBytes) {
     juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
-    tremoloRate = stream.readFloat();
-    tremoloOn = stream.readBool();
+
+    if (sizeInBytes == legacyStateSize)
+    {
+        setTremoloRate(stream.readFloat());
+        setTremoloOn(stream.readBool());
+        return;
+    }
+
+    if (sizeInBytes < 8 || stream.readInt() != stateMagic)
+        return;
+
+    const int version = stream.readInt();
+    auto state = juce::ValueTree::readFromStream(stream);
+
+    if (version > currentStateVersion || ! state.hasType(parameters.state.getType()))
+        return;  // Written by a newer build, keep the current settings rather than guess
+
+    requestedOversampling = juce::jlimit(0, numOversamplingFactors - 1, static_cast<int>(state.getProperty("oversampling", 0)));
+    requestedLatencyMode = juce::jlimit(0, 2, static_cast<int>(state.getProperty("latencyMode", static_cast<int>(LatencyMode::lowLatency))));
+    requestedClippingMode = static_cast<ClippingMode>(juce::jlimit(0, CircuitModel::numClippingModes - 1, static_cast<int>(state.getProperty("solver", 1))));
+    parameters.replaceState(state);
 }
 
 //==============================================================================
@@ -250,103 +892,45 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 }
 
 //==============================================================================
-// Distortion-related functions
-void DisruptionAudioProcessor::updateDistortionCoefficients() {
-    R1 = Ts / (2.f * C1);  // Update resistance based on sampling period and capacitance
-    updateDistortionGroupedResistances();  // Update grouped resistances
-}
-
-void DisruptionAudioProcessor::updateDistortionGroupedResistances() {
-    G_distortion = 1.f / (R1 + R3 + Rp);  // Calculate conductance
-    Gb = (R3 + Rp) * G_distortion;  // Update Gb based on resistances
-    Gi = 1.f + R4 * G_distortion;  // Update Gi
-    Gx1 = R1 * R4 * G_distortion;  // Update Gx1
-}
-
-float DisruptionAudioProcessor::processDistortionSample(float Vi, float& x1) {
-
-    float Vb = Gb * Vi - R1 * Gb * x1;  // Calculate Vb
-    float Vr1 = Vi - Vb;  // Calculate Vr1
-    float Vo = Gi * Vi - Gx1 * x1;  // Calculate output voltage
-
-    // Clipping threshold for distortion
-    if (Vo > 4.5f) {
-        Vo = 4.5f;
-    }
-    else if (Vo < -4.5f) {
-        Vo = -4.5f;
-    }
-
-    // Update x1
-    x1 = (2.f * Vr1 / R1) - x1;
-    return Vo;
+// Circuit
+void DisruptionAudioProcessor::prepareDistortion(float newFs) {
+    circuit.setSampleRate(newFs);
 }
 
-void DisruptionAudioProcessor::setDistortionKnob(float disKnob) {
-
-    if (disKnob != potDis) {
-        potDis = potDis + 0.1f * (disKnob - potDis);  // Adjust the smoothing factor as needed
-        Rp = 1.e6 * (1.f - potDis);  // Update Rp based on knob value
-        updateDistortionGroupedResistances();  // Update grouped resistances
-    }
+void DisruptionAudioProcessor::prepareClipping(float newFs) {
+    circuit.setSampleRate(newFs);
 }
 
-void DisruptionAudioProcessor::prepareDistortion(float newFs) {
-    if (newFs != Fs) {
-        Fs = newFs;  // Update sample rate
-        updateDistortionCoefficients();  // Recalculate coefficients based on new sample rate
-    }
+DisruptionAudioProcessor::SolverStatistics DisruptionAudioProcessor::getSolverStatistics() const
+{
+    SolverStatistics statistics;
+    statistics.samples = publishedSolverSamples.load();
+    statistics.iterations = publishedSolverIterations.load();
+    statistics.nonConverged = publishedSolverNonConverged.load();
+    statistics.maxIterations = publishedSolverMaxIterations.load();
+    return statistics;
 }
 
-//==============================================================================
-// Clipping-related functions
-void DisruptionAudioProcessor::updateClippingCoefficients() {
-    Ts = 1.f / Fs;  // Sampling period
-    R2 = Ts / (2.f * C2);  // Update R2 based on sampling period and capacitance
-    updateClippingGroupedResistances();  // Update grouped resistances for clipping
-}
-
-void DisruptionAudioProcessor::updateClippingGroupedResistances() {
-    G_clipping = (1 / R5 + 1 / R2);  // Update conductance for clipping
-}
-
-float DisruptionAudioProcessor::processClippingSample(float Vi, float& x2) {
-    float b = 1.f; // for dampening
-    float fd = -Vi / R2 + Is * sinh(Vd / (eta * Vt)) + G_clipping * Vd - x2;
-    for (int i = 0; i < 50 && abs(fd) > thr; ++i) {
-        float fdd = (Is / (eta * Vt)) * cosh(Vd / (eta * Vt)) + G_clipping;
-        float Vnew = Vd - b * fd / fdd;
-        float fn = -Vi / R2 + Is * sinh(Vnew / (eta * Vt)) + G_clipping * Vnew - x2;
-        if (abs(fn) < abs(fd)) {
-            Vd = Vnew;
-            b = 1.f;
-        }
-        else {
-            b *= 0.5f;
-        }
-
-        fd = -Vi / R2 + Is * sinh(Vd / (eta * Vt)) + G_clipping * Vd - x2;
-    }
-
-    x2 = 2 * Vd / R2 - x2;
-    return  potLev * Vd;
+void DisruptionAudioProcessor::resetSolverStatistics()
+{
+    publishedSolverSamples = 0;
+    publishedSolverIterations = 0;
+    publishedSolverNonConverged = 0;
+    publishedSolverMaxIterations = 0;
 }
 
-void DisruptionAudioProcessor::setClippingKnob(float levelKnob) {
-    if (potLev != levelKnob) {
-        potLev = 0.00001f + 0.99998f * levelKnob;  // Scale the level knob value
-    }
-}
+void DisruptionAudioProcessor::publishSolverStatistics(const SolverStatistics& blockStatistics)
+{
+    // Called once per block, the circuit counts per sample in plain members
+    publishedSolverSamples += blockStatistics.samples;
+    publishedSolverIterations += blockStatistics.iterations;
+    publishedSolverNonConverged += blockStatistics.nonConverged;
 
-void DisruptionAudioProcessor::prepareClipping(float newFs) {
-    if (newFs != Fs) {
-        Fs = newFs;  // Update sample rate
-        updateClippingCoefficients();  // Recalculate coefficients based on new sample rate
-    }
+    if (blockStatistics.maxIterations > publishedSolverMaxIterations.load())
+        publishedSolverMaxIterations = blockStatistics.maxIterations;
 }
 
-
 void DisruptionAudioProcessor::setTremoloRate(float newRate)
 {
-    tremoloRate = newRate; // Update the tremolo rate
+    setParameterValue(ParameterIDs::tremoloRate, newRate); // Update the tremolo rate
 }
@@ -2,9 +2,38 @@
 
 #include <JuceHeader.h>
 #include "PedalComponent.h"
+#include "CircuitModel.h"
+#include "StageTimings.h"
+#include "LoadMonitor.h"
+#include "MeterFifo.h"
+#include "SpectrumAnalyser.h"
+#include "DSPArena.h"
+#include "AudioThreadGuard.h"
+#include "LFO.h"
+#include "Chorus.h"
 
 //==============================================================================
-class DisruptionAudioProcessor : public juce::AudioProcessor
+// Host visible parameter IDs, also the property names in the saved state
+namespace ParameterIDs
+{
+    inline constexpr auto drive = "drive";
+    inline constexpr auto level = "level";
+    inline constexpr auto tremoloRate = "tremoloRate";
+    inline constexpr auto tremoloOn = "tremoloOn";
+    inline constexpr auto tremoloDepth = "tremoloDepth";
+    inline constexpr auto tremoloShape = "tremoloShape";
+    inline constexpr auto tremoloSpread = "tremoloSpread";
+    inline constexpr auto tempoSync = "tempoSync";
+    inline constexpr auto syncDivision = "syncDivision";
+    inline constexpr auto chorusDepth = "chorusDepth";
+    inline constexpr auto chorusMix = "chorusMix";
+    inline constexpr auto bypass = "bypass";
+}
+
+//==============================================================================
+class DisruptionAudioProcessor : public juce::AudioProcessor,
+                                 private juce::Timer,
+                                 private CircuitModel::StageListener
 {
 public:
     //==============================================================================
@@ -16,22 +45,93 @@ public:
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
     void releaseResources() override;
 
-    // Getter and setter for distortion value (drive knob)
-    float getDistortionValue() const { return distortionValue; }
-    void setDistortionValue(float newValue) { distortionValue = newValue; setDistortionKnob(newValue); }
+    // All user controls are host automatable parameters, the editor attaches to these
+    juce::AudioProcessorValueTreeState& getParameters() { return parameters; }
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    // Getter and setter for level value
-    float getLevelValue() const { return levelValue; }
-    void setLevelValue(float newValue) { levelValue = newValue; setClippingKnob(newValue); }
+    // Getter and setter for distortion value (drive knob). The setters notify the host
+    // like a knob change, the audio thread ramps to the new value over parameterRampMs
+    float getDistortionValue() const { return distortionValue->load(); }
+    void setDistortionValue(float newValue) { setParameterValue(ParameterIDs::drive, newValue); }
 
+    // Getter and setter for level value, ramped the same way
+    float getLevelValue() const { return levelValue->load(); }
+    void setLevelValue(float newValue) { setParameterValue(ParameterIDs::level, newValue); }
 
-    // Methods to prepare distortion and clipping with sample rate
+
+    // Methods to prepare distortion and clipping with sample rate. Both stages share one
+    // circuit rate, so either call retunes the whole circuit (not realtime safe)
     void prepareDistortion(float newFs);
     void prepareClipping(float newFS);
 
-    // Getter and setter for effectOn
-    bool isEffectOn() const { return effectOn; }
-    void setEffectOn(bool isOn) { effectOn = isOn; }
+    // Solver used for the diode equation in the clipping stage
+    using ClippingMode = CircuitModel::ClippingMode;
+
+    ClippingMode getClippingMode() const { return requestedClippingMode.load(); }
+    void setClippingMode(ClippingMode newMode) { requestedClippingMode = newMode; }
+
+    // Newton solver convergence, accumulated over all channels until reset
+    using SolverStatistics = CircuitModel::SolverStatistics;
+
+    SolverStatistics getSolverStatistics() const;  // Safe to call from any thread
+    void resetSolverStatistics();
+
+    // Worst case error of the lookup table against the Newton reference, in volts
+    float getClippingTableError() const { return circuit.getClippingTableError(); }
+
+    // Oversampling around the distortion and clipping stages, trades CPU for aliasing
+    enum class OversamplingFactor
+    {
+        x1,  // Off, the post filter masks aliasing instead
+        x2,
+        x4,
+        x8
+    };
+
+    OversamplingFactor getOversamplingFactor() const { return static_cast<OversamplingFactor>(requestedOversampling.load()); }
+    void setOversamplingFactor(OversamplingFactor newFactor) { requestedOversampling = static_cast<int>(newFactor); }
+
+    // Which chain the circuit runs in, trades round-trip latency against aliasing and phase
+    enum class LatencyMode
+    {
+        zeroLatency,  // No oversampling, minimum phase iir post filter, 0 samples latency
+        lowLatency,   // Oversampling factor above with IIR half-band filters, a few samples
+        highQuality   // Linear phase FIR half-band filters, at least 2x oversampling
+    };
+
+    LatencyMode getLatencyMode() const { return static_cast<LatencyMode>(requestedLatencyMode.load()); }
+    void setLatencyMode(LatencyMode newMode) { requestedLatencyMode = static_cast<int>(newMode); }
+
+    // Latency the given mode would report with the current oversampling factor, valid after prepareToPlay
+    int getLatencyForMode(LatencyMode mode) const;
+
+    // Interleaved SIMD kernel, runs the channels in groups of FloatLanes::size. Mono uses
+    // the scalar code
+    bool isSIMDKernelEnabled() const { return simdKernelEnabled.load(); }
+    void setSIMDKernelEnabled(bool shouldBeEnabled) { simdKernelEnabled = shouldBeEnabled; }
+
+    // Attach a StageTimings object to accumulate per-stage processing time into, or nullptr
+    // to stop timing. Only meant for offline tools, the processor does not own the object.
+    void setStageTimings(StageTimings* timingsToFill) { stageTimings = timingsToFill; }
+
+    // Realtime load of this instance, for the editor overlay and the load log
+    LoadMonitor& getLoadMonitor() { return loadMonitor; }
+
+    // Input, output and circuit drive levels of every block, for the editor's meters
+    MeterFifo& getMeterFifo() { return meterFifo; }
+
+    // Scope and spectrum of the output, for the editor's analyser
+    SpectrumAnalyser& getSpectrumAnalyser() { return analyser; }
+
+    // Hosts show this as their own bypass switch, toggling it crossfades to the dry signal
+    juce::AudioProcessorParameter* getBypassParameter() const override;
+
+    // Getter and setter for effectOn, the inverse of the bypass parameter
+    bool isEffectOn() const { return bypassValue->load() < 0.5f; }
+    void setEffectOn(bool isOn) { setParameterValue(ParameterIDs::bypass, isOn ? 0.f : 1.f); }
+
+    // Largest main bus the pedal accepts, e.g. 7.1.4 beds or 16 channel stems
+    static constexpr int maxChannels = 16;
 
 #ifndef JucePlugin_PreferredChannelConfigurations
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
@@ -61,86 +161,192 @@ public:
     void setStateInformation(const void* data, int sizeInBytes) override;
 
     // Tremolo effect parameters
-    float getTremoloRate() const { return tremoloRate; }
+    float getTremoloRate() const { return tremoloRate->load(); }
     void setTremoloRate(float newRate); // Only declare here
 
-    bool isTremoloOn() const { return tremoloOn; }
-    void setTremoloOn(bool isOn) { tremoloOn = isOn; }
+    bool isTremoloOn() const { return tremoloOn->load() >= 0.5f; }
+    void setTremoloOn(bool isOn) { setParameterValue(ParameterIDs::tremoloOn, isOn ? 1.f : 0.f); }
 
 
 private:
     //==============================================================================
-    // Sample rate and time variables
-    float Fs;  // Sample rate
-    float inverseSampleRate;
-    float Ts;  // Sampling period
+    // Parameters and saved state
+    juce::AudioProcessorValueTreeState parameters;
 
-    // Declare an array to store the last sample for each channel
-    std::vector<float> lastSample;  // Initialize with 0.0f for each channel
+    // Bumped whenever the saved state layout changes, older versions are migrated on load
+    static constexpr int currentStateVersion = 1;
 
-    //==============================================================================
-    // Distortion-related parameters and methods
-    float distortionValue = 0.5f;  // Default distortion value
-    float C1;  // Capacitance for distortion circuit
-    float R1;  // Resistance R1
-    float x1;  // State variable for distortion
-    float R3;  // Resistance R3
-    float R4;  // Resistance R4
-    float potDis;  // Distortion knob value
-    float Rp;  // Potentiometer resistance for distortion
-    float G_distortion; // Conductance for distortion
-    float Gb;  // Conductance for branch B
-    float Gi;  // Input conductance
-    float Gx1; // Conductance for x1
-
-    void updateDistortionCoefficients();  // Update coefficients for distortion
-    void updateDistortionGroupedResistances();  // Update grouped resistances for distortion
+    void setParameterValue(const juce::String& parameterID, float newValue);  // Value in the parameter's own range
 
     //==============================================================================
-    // Clipping-related parameters and methods
-    void updateClippingCoefficients();  // Update coefficients for clipping
-    void updateClippingGroupedResistances();  // Update grouped resistances for clipping
-    float levelValue = 0.5f;       // Default level value
+    // Distortion and clipping stages, with every channel's circuit state
+    CircuitModel circuit;
+
+    std::atomic<float>* distortionValue = nullptr;  // Raw parameter value, read once per block
+    std::atomic<float>* levelValue = nullptr;       // Raw parameter value, read once per block
 
-    float C2;  // Capacitance for clipping circuit
-    float R2;  // Resistance R2
-    float x2;  // State variable for clipping
-    float R5;  // Resistance R5
-    float potLev;  // Output level control
-    float Vd;  // Voltage across the diode
-    float thr; // Threshold for convergence
+    std::atomic<ClippingMode> requestedClippingMode;  // Written by the message thread
 
-    const float eta = 2.f;  // Diode emission coefficient
-    const float Is = 1.e-6;  // Reverse saturation current
-    const float Vt = 26.e-3;  // Thermal voltage
-    float G_clipping;   // Conductance for clipping
+    // Solver statistics, published once per block from the circuit's plain counters
+    std::atomic<juce::uint64> publishedSolverSamples { 0 };
+    std::atomic<juce::uint64> publishedSolverIterations { 0 };
+    std::atomic<juce::uint64> publishedSolverNonConverged { 0 };
+    std::atomic<int> publishedSolverMaxIterations { 0 };
+    void publishSolverStatistics(const SolverStatistics& blockStatistics);
 
-    // Declare state variables for each channel
-    std::vector<float> x1State;  // State variable for distortion
-    std::vector<float> x2State;  // State variable for clipping (if needed)
+    MeterFifo meterFifo;
+    static void measureLevels(const juce::AudioBuffer<float>& buffer, int numChannels, float& peak, float& meanSquare);
+    void pushMeterBlock(MeterBlock& meter, const juce::AudioBuffer<float>& buffer, int numChannels);  // Adds the output levels
 
+    SpectrumAnalyser analyser;  // Takes output snapshots while the editor shows the analyser
+
+    // Owns the scratch buffers below, sized in prepareToPlay
+    DSPArena arena;
 
     //==============================================================================
     // Effect control
-    bool effectOn;
-    void setDistortionKnob(float disKnob);  // Update distortion knob
-    void setClippingKnob(float levelKnob);  // Update clipping knob
+    std::atomic<float>* bypassValue = nullptr;
+
+    // Knob ramps, advanced once per circuit sample so their length does not depend on
+    // the block size or the oversampling factor
+    static constexpr double parameterRampMs = 20.0;
+    juce::SmoothedValue<float> driveSmoother;
+    juce::SmoothedValue<float> levelSmoother;
+    void resetParameterSmoothing(double circuitRate);  // Jump to the current targets at a new rate
 
-    // Distortion and Clipping processing
-    float processDistortionSample(float Vi, float& x1);
-    float processClippingSample(float Vi, float& x2);
+    // The whole pedal over the first numChannels channels of buffer, after processBlock has
+    // matched the input layout to the output and split it into blocks of at most
+    // preparedBlockSize, ending at chain switches. sampleOffset is where buffer starts in
+    // the host block
+    void processChannels(juce::AudioBuffer<float>& buffer, int numChannels, int sampleOffset);
+
+    // Runs the distortion and clipping stages over a block at the circuit rate
+    void processCircuit(juce::dsp::AudioBlock<float>& block);
+
+    // Knob values per circuit sample while a ramp is active, shared by all channels
+    DSPArena::Array<float> driveRamp;
+    DSPArena::Array<float> levelRamp;
+
+    //==============================================================================
+    // Bypass and idle detection
+    static constexpr double bypassFadeMs = 10.0;
+    juce::SmoothedValue<float> bypassFade;  // Dry gain, 0 while processing and 1 when bypassed
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> dryDelay;  // Delays the dry signal by the reported latency
+    juce::AudioBuffer<float> dryBuffer;  // Delayed dry signal of the current block, refers to dryChannels
+    std::array<float*, maxChannels> dryChannels {};
+    void delayDrySignal(const juce::AudioBuffer<float>& buffer, int numChannels);
+
+    // Circuit and effects are skipped after input, diode voltage and output all stay below
+    // silenceThreshold for silenceHoldSeconds, long enough for the chorus and filter tails
+    static constexpr float silenceThreshold = 3.2e-5f;  // About -90 dBFS
+    static constexpr double silenceHoldSeconds = 0.2;
+    int silenceHoldSamples = 0;
+    int silentSamples = 0;
+    float lastOutputPeak = 0.f;
+    bool processingSuspended = false;  // Set while bypassed or idle, processing restarts from cleared state
+    bool updateSilenceDetector(const juce::AudioBuffer<float>& buffer, int numChannels);  // True while processing can be skipped
+    void resetProcessingState();  // Clear the circuit, oversampler and effect states
+
+    // Stage timing for offline tools and the load monitor, a flag check per stage when
+    // neither is listening
+    StageTimings* stageTimings = nullptr;
+    StageTimings blockTimings;  // Current block, added to stageTimings at the end of it
+    bool timingStages = false;
+    juce::int64 stageStartTicks = 0;
+    void markStageEnd(StageTimings::Stage stage);  // Adds the time since the previous mark to stage
+    void circuitStageFinished(StageTimings::Stage stage) override { markStageEnd(stage); }
+
+    LoadMonitor loadMonitor;
+
+    // Keeps the editor typeface, images and artwork decoded while editors are closed. Empty
+    // until the first editor of the process opens
+    juce::SharedResourcePointer<PedalResources> editorResources;
+
+   #if DISRUPTION_INSTRUMENTATION
+    void pushLoadReport(LoadMonitor::BlockReport& report, juce::int64 blockStartTicks, int numSamples);
+   #endif
+
+    std::atomic<bool> simdKernelEnabled;
+
+    //==============================================================================
+    // Oversampling
+    static constexpr int numOversamplingFactors = 4;
+    static_assert(numOversamplingFactors <= CircuitModel::maxOrders, "The circuit builds every order");
+
+    // Index is the oversampling order, order 0 runs at the host rate without an oversampler.
+    // Both filter types are built in prepareToPlay, so switching never allocates
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, numOversamplingFactors> oversamplers;  // IIR, low latency
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, numOversamplingFactors> linearPhaseOversamplers;  // FIR
+
+    std::atomic<int> requestedOversampling { 0 };  // Written by the message thread
+    std::atomic<int> requestedLatencyMode { static_cast<int>(LatencyMode::lowLatency) };
+    int activeOversampling = 0;  // Order used by the audio thread
+    bool activeLinearPhase = false;
+    juce::dsp::Oversampling<float>* activeOversampler = nullptr;  // Null at order 0
+    double hostSampleRate = 44100.0;  // Rate passed to prepareToPlay
+    int preparedBlockSize = 0;        // Every per-block buffer holds this many samples, larger host blocks are split
+
+    // Order and filter type for a latency mode and oversampling factor
+    struct CircuitChain
+    {
+        int order = 0;
+        bool linearPhase = false;
+    };
+
+    CircuitChain getChain(LatencyMode mode, int requestedOrder) const;
+
+    // Chain switches fade the output out, switch, and fade back in, so the latency jump
+    // does not click. The whole output fades, including the dry signal, whose delay
+    // follows the chain latency
+    static constexpr double chainFadeMs = 5.0;
+    juce::SmoothedValue<float> chainFade;
+    int chainFadeSamples = 0;     // Length of a fade-out
+    int chainFadeOutSamples = 0;  // Left of the running fade-out, processBlock ends the part there
+
+    // Before each part, switches to the requested chain once the output has faded out and
+    // starts or reverses the fade. Returns the samples until the switch can happen
+    int updateChain();
+
+    void setActiveOversampling(int order, bool linearPhase);  // Switch chain, coefficients and reported latency
+
+    std::atomic<int> pendingLatency { 0 };  // Latency of the active chain, reported to the host by the timer
+    static constexpr int latencyPollMs = 50;
+    void timerCallback() override;
 
 
     //==============================================================================
     // Tremolo-related parameters
-    float tremoloRate;
-    bool tremoloOn;
-    double tremoloPhase;
-    float tremoloDepth;
+    std::atomic<float>* tremoloRate = nullptr;
+    std::atomic<float>* tremoloOn = nullptr;
+    std::atomic<float>* tremoloDepth = nullptr;
+    std::atomic<float>* tremoloShape = nullptr;  // Index into LFO::Shape
+    std::atomic<float>* tremoloSpread = nullptr;  // Phase of the last channel against the first, in cycles
+
+    std::atomic<float>* tempoSync = nullptr;
+    std::atomic<float>* syncDivision = nullptr;  // Index into the note divisions in PluginProcessor.cpp
+
+    LFO tremoloLFO;
+    juce::SmoothedValue<float> tremoloDepthSmoother;  // Ramps to 0 while the tremolo is off
+    DSPArena::Array<float> tremoloDepths;  // Per sample depth of the current block
+    void updateTremoloSpread(int numChannels);  // Channel phase offsets, evenly over the spread
+
+    //==============================================================================
+    // Host tempo sync. While synced the tremolo and chorus phases are derived from the host
+    // position every block instead of accumulated, so they cannot drift and renders match
+    // playback
+    double hostBpm = 120.0;  // Last tempo reported by the host
+    void updateTempoSync(int sampleOffset);  // Offset of the current block from the host position
 
     //==============================================================================
-    // Chorus effect
-    juce::dsp::Chorus<float> chorus;
+    // Chorus effect, runs while the tremolo is on. Its sine LFO follows the same tempo
+    // clock as the tremolo, once per bar while synced
+    static constexpr float chorusRate = 0.5f;  // Hz while not synced
+    static constexpr float chorusFeedback = 0.2f;
+    std::atomic<float>* chorusDepth = nullptr;
+    std::atomic<float>* chorusMix = nullptr;
+
+    LFO chorusLFO;
+    Chorus chorus;
 
     //==============================================================================
     // Filters
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Minimal four lane float vector used by the interleaved circuit kernels.
+//
+// juce::dsp::SIMDRegister has no division, which the Newton step needs, so this wraps
+// SSE2 on x86 and NEON on AArch64 directly. Other targets get a plain scalar version
+// with the same interface and DISRUPTION_HAS_SIMD_LANES set to 0.
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define DISRUPTION_SIMD_SSE2 1
+ #define DISRUPTION_HAS_SIMD_LANES 1
+#elif defined (__aarch64__) || defined (_M_ARM64)
+ #include <arm_neon.h>
+ #define DISRUPTION_SIMD_NEON 1
+ #define DISRUPTION_HAS_SIMD_LANES 1
+#else
+ #define DISRUPTION_HAS_SIMD_LANES 0
+#endif
+
+struct FloatLanes
+{
+    static constexpr int size = 4;
+
+   #if DISRUPTION_SIMD_SSE2
+    __m128 value;
+
+    static inline FloatLanes load(const float* p) noexcept       { return { _mm_loadu_ps(p) }; }
+    inline void store(float* p) const noexcept                   { _mm_storeu_ps(p, value); }
+    static inline FloatLanes expand(float s) noexcept            { return { _mm_set1_ps(s) }; }
+
+    inline FloatLanes operator+(FloatLanes o) const noexcept     { return { _mm_add_ps(value, o.value) }; }
+    inline FloatLanes operator-(FloatLanes o) const noexcept     { return { _mm_sub_ps(value, o.value) }; }
+    inline FloatLanes operator*(FloatLanes o) const noexcept     { return { _mm_mul_ps(value, o.value) }; }
+    inline FloatLanes operator/(FloatLanes o) const noexcept     { return { _mm_div_ps(value, o.value) }; }
+
+    static inline FloatLanes min(FloatLanes a, FloatLanes b) noexcept { return { _mm_min_ps(a.value, b.value) }; }
+    static inline FloatLanes max(FloatLanes a, FloatLanes b) noexcept { return { _mm_max_ps(a.value, b.value) }; }
+    static inline FloatLanes abs(FloatLanes a) noexcept          { return { _mm_andnot_ps(_mm_set1_ps(-0.f), a.value) }; }
+
+    // Comparisons return all-ones lanes where true, used with select() and any()
+    static inline FloatLanes lessThan(FloatLanes a, FloatLanes b) noexcept    { return { _mm_cmplt_ps(a.value, b.value) }; }
+    static inline FloatLanes greaterThan(FloatLanes a, FloatLanes b) noexcept { return { _mm_cmpgt_ps(a.value, b.value) }; }
+    static inline FloatLanes logicalAnd(FloatLanes a, FloatLanes b) noexcept  { return { _mm_and_ps(a.value, b.value) }; }
+    static inline FloatLanes select(FloatLanes mask, FloatLanes a, FloatLanes b) noexcept
+    {
+        return { _mm_or_ps(_mm_and_ps(mask.value, a.value), _mm_andnot_ps(mask.value, b.value)) };
+    }
+    static inline bool any(FloatLanes mask) noexcept             { return _mm_movemask_ps(mask.value) != 0; }
+
+   #elif DISRUPTION_SIMD_NEON
+    float32x4_t value;
+
+    static inline FloatLanes load(const float* p) noexcept       { return { vld1q_f32(p) }; }
+    inline void store(float* p) const noexcept                   { vst1q_f32(p, value); }
+    static inline FloatLanes expand(float s) noexcept            { return { vdupq_n_f32(s) }; }
+
+    inline FloatLanes operator+(FloatLanes o) const noexcept     { return { vaddq_f32(value, o.value) }; }
+    inline FloatLanes operator-(FloatLanes o) const noexcept     { return { vsubq_f32(value, o.value) }; }
+    inline FloatLanes operator*(FloatLanes o) const noexcept     { return { vmulq_f32(value, o.value) }; }
+    inline FloatLanes operator/(FloatLanes o) const noexcept     { return { vdivq_f32(value, o.value) }; }
+
+    static inline FloatLanes min(FloatLanes a, FloatLanes b) noexcept { return { vminq_f32(a.value, b.value) }; }
+    static inline FloatLanes max(FloatLanes a, FloatLanes b) noexcept { return { vmaxq_f32(a.value, b.value) }; }
+    static inline FloatLanes abs(FloatLanes a) noexcept          { return { vabsq_f32(a.value) }; }
+
+    static inline FloatLanes lessThan(FloatLanes a, FloatLanes b) noexcept    { return { vreinterpretq_f32_u32(vcltq_f32(a.value, b.value)) }; }
+    static inline FloatLanes greaterThan(FloatLanes a, FloatLanes b) noexcept { return { vreinterpretq_f32_u32(vcgtq_f32(a.value, b.value)) }; }
+    static inline FloatLanes logicalAnd(FloatLanes a, FloatLanes b) noexcept
+    {
+        return { vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a.value), vreinterpretq_u32_f32(b.value))) };
+    }
+    static inline FloatLanes select(FloatLanes mask, FloatLanes a, FloatLanes b) noexcept
+    {
+        return { vbslq_f32(vreinterpretq_u32_f32(mask.value), a.value, b.value) };
+    }
+    static inline bool any(FloatLanes mask) noexcept             { return vmaxvq_u32(vreinterpretq_u32_f32(mask.value)) != 0; }
+
+   #else
+    float value[size];
+
+    static inline FloatLanes load(const float* p) noexcept       { FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = p[i]; return r; }
+    inline void store(float* p) const noexcept                   { for (int i = 0; i < size; ++i) p[i] = value[i]; }
+    static inline FloatLanes expand(float s) noexcept            { FloatLanes r; for (auto& v : r.value) v = s; return r; }
+
+    inline FloatLanes operator+(FloatLanes o) const noexcept     { FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = value[i] + o.value[i]; return r; }
+    inline FloatLanes operator-(FloatLanes o) const noexcept     { FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = value[i] - o.value[i]; return r; }
+    inline FloatLanes operator*(FloatLanes o) const noexcept     { FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = value[i] * o.value[i]; return r; }
+    inline FloatLanes operator/(FloatLanes o) const noexcept     { FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = value[i] / o.value[i]; return r; }
+
+    static inline FloatLanes min(FloatLanes a, FloatLanes b) noexcept { FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = juce::jmin(a.value[i], b.value[i]); return r; }
+    static inline FloatLanes max(FloatLanes a, FloatLanes b) noexcept { FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = juce::jmax(a.value[i], b.value[i]); return r; }
+    static inline FloatLanes abs(FloatLanes a) noexcept          { FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = std::abs(a.value[i]); return r; }
+
+    // The scalar version stores masks as 1 / 0 instead of bit patterns
+    static inline FloatLanes lessThan(FloatLanes a, FloatLanes b) noexcept    { FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = a.value[i] < b.value[i] ? 1.f : 0.f; return r; }
+    static inline FloatLanes greaterThan(FloatLanes a, FloatLanes b) noexcept { FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = a.value[i] > b.value[i] ? 1.f : 0.f; return r; }
+    static inline FloatLanes logicalAnd(FloatLanes a, FloatLanes b) noexcept  { FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = a.value[i] * b.value[i]; return r; }
+    static inline FloatLanes select(FloatLanes mask, FloatLanes a, FloatLanes b) noexcept
+    {
+        FloatLanes r; for (int i = 0; i < size; ++i) r.value[i] = mask.value[i] != 0.f ? a.value[i] : b.value[i]; return r;
+    }
+    static inline bool any(FloatLanes mask) noexcept             { for (auto v : mask.value) if (v != 0.f) return true; return false; }
+   #endif
+
+    //==============================================================================
+    // exp(x) for |x| <= 16: degree 7 Taylor polynomial of exp(x / 32), squared five times.
+    // Relative error stays below 1e-5 over the clamped range, which is far below the
+    // Newton tolerance of the diode solver.
+    static inline FloatLanes exp(FloatLanes x) noexcept
+    {
+        const auto y = min(max(x, expand(-16.f)), expand(16.f)) * expand(1.f / 32.f);
+
+        auto e = expand(1.f / 5040.f);
+        e = e * y + expand(1.f / 720.f);
+        e = e * y + expand(1.f / 120.f);
+        e = e * y + expand(1.f / 24.f);
+        e = e * y + expand(1.f / 6.f);
+        e = e * y + expand(0.5f);
+        e = e * y + expand(1.f);
+        e = e * y + expand(1.f);
+
+        for (int i = 0; i < 5; ++i)
+            e = e * e;
+
+        return e;
+    }
+
+    // sinh and cosh of the same argument share one exp and one division
+    static inline void sinhCosh(FloatLanes x, FloatLanes& sinhOut, FloatLanes& coshOut) noexcept
+    {
+        const auto e = exp(x);
+        const auto eInv = expand(1.f) / e;
+        sinhOut = (e - eInv) * expand(0.5f);
+        coshOut = (e + eInv) * expand(0.5f);
+    }
+};
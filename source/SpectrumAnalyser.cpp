@@ -0,0 +1,206 @@
+#include "SpectrumAnalyser.h"
+
+//==============================================================================
+SpectrumAnalyser::SpectrumAnalyser()
+    : juce::Thread("Disruption analyser")
+{
+    snapshots.resize(static_cast<size_t>(numSnapshots * fftSize));
+    fftData.resize(static_cast<size_t>(2 * fftSize));
+
+    // A full scale sine at a bin centre shows as the window sum over two
+    std::vector<float> ones(static_cast<size_t>(fftSize), 1.f);
+    window.multiplyWithWindowingTable(ones.data(), ones.size());
+    windowGain = 0.5f * std::accumulate(ones.begin(), ones.end(), 0.f);
+
+    frame.spectrum.fill(minimumDb);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    enabled = false;
+    stopThread(2 * updateIntervalMs + 100);
+}
+
+void SpectrumAnalyser::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    captureSlot = -1;
+    capturePosition = 0;
+    samplesToSkip = 0;
+}
+
+void SpectrumAnalyser::setActive(bool shouldBeActive)
+{
+    if (shouldBeActive == isThreadRunning())
+        return;
+
+    if (shouldBeActive)
+    {
+        // Nothing reads the FIFO while the thread is stopped, so start from an empty one
+        fifo.finishedRead(fifo.getNumReady());
+
+        {
+            const juce::ScopedLock sl(frameLock);
+            frame = {};
+            frame.spectrum.fill(minimumDb);
+        }
+
+        enabled = true;
+        startThread();
+    }
+    else
+    {
+        enabled = false;
+        stopThread(2 * updateIntervalMs + 100);
+    }
+}
+
+SpectrumAnalyser::Frame SpectrumAnalyser::getFrame() const
+{
+    const juce::ScopedLock sl(frameLock);
+    return frame;
+}
+
+void SpectrumAnalyser::push(const juce::dsp::AudioBlock<const float>& block) noexcept
+{
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    const int numChannels = static_cast<int>(block.getNumChannels());
+
+    if (numChannels == 0)
+        return;
+
+    const float channelGain = 1.f / static_cast<float>(numChannels);
+    int position = 0;
+
+    while (position < numSamples)
+    {
+        // Between snapshots, skipping is all the work
+        if (samplesToSkip > 0)
+        {
+            const int skipped = juce::jmin(samplesToSkip, numSamples - position);
+            samplesToSkip -= skipped;
+            position += skipped;
+            continue;
+        }
+
+        if (captureSlot < 0)
+        {
+            int start1, size1, start2, size2;
+            fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+            if (size1 == 0)
+            {
+                // Full, the analysis thread is not keeping up. Wait for the next snapshot
+                samplesToSkip = fftSize;
+                continue;
+            }
+
+            captureSlot = start1;
+            capturePosition = 0;
+        }
+
+        // Mono mix of the channels
+        const int numToCopy = juce::jmin(fftSize - capturePosition, numSamples - position);
+        float* destination = snapshots.data() + captureSlot * fftSize + capturePosition;
+
+        juce::FloatVectorOperations::copyWithMultiply(destination, block.getChannelPointer(0) + position, channelGain, numToCopy);
+
+        for (int channel = 1; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::addWithMultiply(destination, block.getChannelPointer(static_cast<size_t>(channel)) + position, channelGain, numToCopy);
+
+        capturePosition += numToCopy;
+        position += numToCopy;
+
+        if (capturePosition == fftSize)
+        {
+            fifo.finishedWrite(1);
+            captureSlot = -1;
+
+            const int snapshotInterval = static_cast<int>(currentSampleRate.load(std::memory_order_relaxed) / snapshotsPerSecond);
+            samplesToSkip = juce::jmax(0, snapshotInterval - fftSize);
+        }
+    }
+}
+
+float SpectrumAnalyser::getBandFrequency(float band, double sampleRate) noexcept
+{
+    const float nyquist = static_cast<float>(sampleRate * 0.5);
+    return minimumFrequency * std::pow(nyquist / minimumFrequency, band / static_cast<float>(numBands));
+}
+
+//==============================================================================
+void SpectrumAnalyser::run()
+{
+    while (! threadShouldExit())
+    {
+        wait(updateIntervalMs);
+
+        // Only the latest snapshot is shown, older ones are skipped
+        const int numReady = fifo.getNumReady();
+
+        if (numReady == 0)
+            continue;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numReady, start1, size1, start2, size2);
+        const int latest = size2 > 0 ? start2 + size2 - 1 : start1 + size1 - 1;
+
+        analyse(snapshots.data() + latest * fftSize);
+        fifo.finishedRead(size1 + size2);
+    }
+}
+
+void SpectrumAnalyser::analyse(const float* snapshot)
+{
+    const double sampleRate = currentSampleRate.load(std::memory_order_relaxed);
+    Frame result;
+    result.sampleRate = sampleRate;
+
+    // Scope, starting at the first rising zero crossing so a steady note stands still
+    const int scopeSamples = juce::jmin(fftSize / 2, juce::roundToInt(scopeMs * 0.001 * sampleRate));
+    int trigger = 0;
+
+    for (int n = 1; n < fftSize - scopeSamples; ++n)
+    {
+        if (snapshot[n - 1] < 0.f && snapshot[n] >= 0.f)
+        {
+            trigger = n;
+            break;
+        }
+    }
+
+    for (int point = 0; point < numScopePoints; ++point)
+    {
+        const float position = static_cast<float>(trigger) + static_cast<float>(point * (scopeSamples - 1)) / static_cast<float>(numScopePoints - 1);
+        const int index = static_cast<int>(position);
+        const float fraction = position - static_cast<float>(index);
+        const float next = snapshot[juce::jmin(index + 1, fftSize - 1)];
+        result.scope[static_cast<size_t>(point)] = snapshot[index] + fraction * (next - snapshot[index]);
+    }
+
+    // Spectrum
+    std::copy(snapshot, snapshot + fftSize, fftData.begin());
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.f);
+    window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    const float binsPerHz = static_cast<float>(fftSize / sampleRate);
+    const int lastBin = fftSize / 2;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        // Loudest bin in the band, bands narrower than a bin repeat it
+        const int first = juce::jmin(lastBin, static_cast<int>(getBandFrequency(static_cast<float>(band), sampleRate) * binsPerHz));
+        const int last = juce::jlimit(first, lastBin, static_cast<int>(getBandFrequency(static_cast<float>(band + 1), sampleRate) * binsPerHz));
+        const float magnitude = *std::max_element(fftData.begin() + first, fftData.begin() + last + 1);
+
+        result.spectrum[static_cast<size_t>(band)] = juce::Decibels::gainToDecibels(magnitude / windowGain, minimumDb);
+    }
+
+    {
+        const juce::ScopedLock sl(frameLock);
+        frame = result;
+    }
+
+    frameCount.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Scope and spectrum of the processor output for the editor's analyser.
+//
+// While a consumer is active, the audio thread copies a mono mix of the output into
+// snapshots of fftSize consecutive samples, at most snapshotsPerSecond of them, and
+// skips the samples in between. A finished snapshot is handed over through a single
+// producer, single consumer FIFO; the audio thread never waits, and drops the snapshot
+// if the FIFO is full. A background thread, running only while a consumer is active,
+// windows and transforms the latest snapshot and publishes a Frame. With no consumer
+// the thread is stopped and the audio thread only checks a flag.
+class SpectrumAnalyser : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;  // About 11 Hz per bin at 44.1 kHz
+    static constexpr int numBands = 256;           // Log spaced from minimumFrequency to Nyquist
+    static constexpr int numScopePoints = 256;
+
+    // Latest analysis, for the editor
+    struct Frame
+    {
+        std::array<float, numBands> spectrum {};   // Peak level per band in dBFS, a full scale sine is 0 dB
+        std::array<float, numScopePoints> scope {};  // scopeMs of waveform from a rising zero crossing
+        double sampleRate = 44100.0;
+    };
+
+    SpectrumAnalyser();
+    ~SpectrumAnalyser() override;
+
+    // Before processing starts, resets the snapshot being captured
+    void prepare(double sampleRate);
+
+    // Consumer, message thread. Starts and stops the analysis thread
+    void setActive(bool shouldBeActive);
+
+    // Any thread but the audio thread. The count increases with every analysed snapshot,
+    // so a view only needs to copy the frame when it changed
+    int getFrameCount() const noexcept { return frameCount.load(std::memory_order_acquire); }
+    Frame getFrame() const;
+
+    // Audio thread
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+    void push(const juce::dsp::AudioBlock<const float>& block) noexcept;
+
+    // Frequency of band, the lowest band starts at minimumFrequency
+    static float getBandFrequency(float band, double sampleRate) noexcept;
+
+    static constexpr int snapshotsPerSecond = 15;
+    static constexpr float minimumFrequency = 20.f;
+    static constexpr float minimumDb = -120.f;
+    static constexpr double scopeMs = 20.0;  // Two periods of the open A string
+    static constexpr int updateIntervalMs = 20;
+
+private:
+    void run() override;
+    void analyse(const float* snapshot);
+
+    // AbstractFifo keeps one slot free, which leaves one snapshot being analysed, one being
+    // captured and one spare
+    static constexpr int numSnapshots = 4;
+    juce::AbstractFifo fifo { numSnapshots };
+    std::vector<float> snapshots;  // numSnapshots * fftSize
+
+    std::atomic<bool> enabled { false };
+    std::atomic<double> currentSampleRate { 44100.0 };
+
+    // Audio thread only
+    int captureSlot = -1;   // FIFO slot being filled, -1 between snapshots
+    int capturePosition = 0;
+    int samplesToSkip = 0;
+
+    // Analysis thread only
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false };
+    std::vector<float> fftData;  // 2 * fftSize, as the frequency only transform needs
+    float windowGain = 1.f;      // Sum of the window over two, the magnitude of a full scale sine
+
+    // Never taken by the audio thread
+    juce::CriticalSection frameLock;
+    Frame frame;
+    std::atomic<int> frameCount { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyser)
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Wall clock time spent in each stage of DisruptionAudioProcessor::processBlock.
+// The processor adds to these while a StageTimings object is attached, so the
+// caller decides when to clear them (e.g. once per block in the benchmark).
+struct StageTimings
+{
+    enum Stage
+    {
+        oversampling,  // Up and down sampling around the circuit
+        distortion,
+        clipping,
+        tremolo,
+        chorus,
+        postFilter,    // 5 kHz iir low-pass
+        numStages
+    };
+
+    static const char* getStageName(int stage)
+    {
+        static const char* const names[] = { "oversampling", "distortion", "clipping", "tremolo", "chorus", "iir" };
+        return names[stage];
+    }
+
+    void clear() { seconds.fill(0.0); }
+
+    std::array<double, numStages> seconds {};
+};
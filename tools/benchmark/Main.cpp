@@ -0,0 +1,988 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../source/PluginProcessor.h"
+
+//==============================================================================
+// Headless benchmark for DisruptionAudioProcessor.
+//
+// Runs processBlock over synthetic and file based inputs for every combination of
+// sample rate, block size and knob setting given on the command line, and prints one
+// JSON document with ns/sample, real-time factor and per-stage percentiles per run.
+//
+// --stress instead drives one processor through random parameter, mode, block size and
+// channel layout changes and checks every output sample is finite. Built with
+// DISRUPTION_AUDIO_THREAD_CHECKS it also fails on any allocation or lock in processBlock.
+//
+// --solvers compares the clipping stage solvers on the bare CircuitModel: worst case error
+// against the double precision reference, iterations per sample and ns per channel sample
+// of the clipping stage, at each circuit rate given with --rates. Exits non-zero if a
+// solver exceeds its error or iteration limit, or leaves a sample unconverged.
+//
+// --chorus compares the plugin's Chorus with juce::dsp::Chorus at the same settings: ns per
+// channel sample on the guitar input, and the gain of fully wet sines, which shows how much
+// treble each delay line interpolation loses while the delay sweeps.
+//
+// --paint times PedalKnobLookAndFeel::drawRotarySlider per knob into an image, with and
+// without the knob body cache, at 1x and 2x pixel scale.
+//
+// --editors opens and closes editors one after another, each painted once, and reports how
+// long the first and the later ones took to open.
+//
+// --monitor=on runs with the realtime load monitor collecting, as it does while the editor
+// shows the DSP load. Compare against off with --stage-timings=off to see its overhead.
+//
+// --analyser=on runs with the spectrum analyser capturing snapshots and its thread running,
+// as while the editor shows it. Off is the cost while it is hidden.
+//
+//   DisruptionBenchmark [--rates=44100,96000] [--blocks=64,512] [--channels=2,8,16] [--drive=0.2,0.8]
+//                       [--level=0.5] [--tremolo=off,on] [--oversampling=1,2,4,8] [--latency=zero,low,high]
+//                       [--solver=table,newton,halley,omega] [--simd=on,off] [--monitor=off,on] [--analyser=off,on]
+//                       [--stage-timings=on|off] [--seconds=2]
+//                       [--inputs=guitar,sine,noise,silence] [--files=a.wav;b.flac] [--output=results.json]
+
+namespace
+{
+    struct RunSettings
+    {
+        juce::String inputName;
+        double sampleRate = 44100.0;
+        int blockSize = 512;
+        int numChannels = 2;  // Inputs are stereo, further channels repeat them
+        float drive = 0.5f;
+        float level = 0.5f;
+        bool tremolo = false;
+        int oversamplingOrder = 0;
+        DisruptionAudioProcessor::LatencyMode latencyMode = DisruptionAudioProcessor::LatencyMode::lowLatency;
+        DisruptionAudioProcessor::ClippingMode clippingMode = DisruptionAudioProcessor::ClippingMode::lookupTable;
+        bool simd = true;
+        bool monitor = false;
+        bool analyser = false;
+        bool stageTimings = true;
+    };
+
+    //==============================================================================
+    juce::StringArray getList(const juce::ArgumentList& args, const juce::String& option, const juce::String& defaultValue)
+    {
+        const auto value = args.containsOption(option) ? args.getValueForOption(option) : defaultValue;
+        auto list = juce::StringArray::fromTokens(value, ",;", "");
+        list.trim();
+        list.removeEmptyStrings();
+        return list;
+    }
+
+    DisruptionAudioProcessor::LatencyMode getLatencyMode(const juce::String& name)
+    {
+        if (name == "zero")
+            return DisruptionAudioProcessor::LatencyMode::zeroLatency;
+
+        return name == "high" ? DisruptionAudioProcessor::LatencyMode::highQuality
+                              : DisruptionAudioProcessor::LatencyMode::lowLatency;
+    }
+
+    const char* getLatencyModeName(DisruptionAudioProcessor::LatencyMode mode)
+    {
+        static const char* const names[] = { "zero", "low", "high" };
+        return names[static_cast<int>(mode)];
+    }
+
+    // Synthetic inputs are generated at the rate under test, so every rate sees the same signal
+    juce::AudioBuffer<float> makeSyntheticInput(const juce::String& name, double sampleRate, double seconds)
+    {
+        const int numSamples = juce::roundToInt(sampleRate * seconds);
+        juce::AudioBuffer<float> buffer(2, numSamples);
+        juce::Random random(1234);
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            const double t = n / sampleRate;
+            float sample = 0.f;
+
+            if (name == "sine")
+            {
+                sample = 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * 110.0 * t));
+            }
+            else if (name == "noise")
+            {
+                sample = 0.5f * (random.nextFloat() * 2.f - 1.f);
+            }
+            else if (name == "silence")
+            {
+                sample = 0.f;  // Measures the idle path
+            }
+            else
+            {
+                // Plucked guitar stand-in: a few inharmonic partials restruck every half second
+                const double envelope = std::exp(-6.0 * std::fmod(t, 0.5));
+                sample = static_cast<float>(0.3 * envelope * (std::sin(juce::MathConstants<double>::twoPi * 110.0 * t)
+                                                              + 0.5 * std::sin(juce::MathConstants<double>::twoPi * 220.7 * t)
+                                                              + 0.3 * std::sin(juce::MathConstants<double>::twoPi * 331.0 * t)));
+            }
+
+            buffer.setSample(0, n, sample);
+            buffer.setSample(1, n, sample);
+        }
+
+        return buffer;
+    }
+
+    bool readFileInput(const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+        if (reader == nullptr)
+            return false;
+
+        const auto numSamples = static_cast<int>(reader->lengthInSamples);
+        buffer.setSize(2, numSamples);
+        reader->read(&buffer, 0, numSamples, 0, true, true);  // Mono files are copied to both channels
+        return true;
+    }
+
+    //==============================================================================
+    double getPercentile(std::vector<double> values, double percentile)
+    {
+        if (values.empty())
+            return 0.0;
+
+        const auto index = static_cast<size_t>(juce::jlimit(0.0, 1.0, percentile / 100.0) * static_cast<double>(values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+        return values[index];
+    }
+
+    juce::var describeDistribution(const std::vector<double>& nsPerSample)
+    {
+        double sum = 0.0;
+
+        for (auto value : nsPerSample)
+            sum += value;
+
+        juce::DynamicObject::Ptr result = new juce::DynamicObject();
+        result->setProperty("mean", nsPerSample.empty() ? 0.0 : sum / static_cast<double>(nsPerSample.size()));
+        result->setProperty("p50", getPercentile(nsPerSample, 50.0));
+        result->setProperty("p90", getPercentile(nsPerSample, 90.0));
+        result->setProperty("p99", getPercentile(nsPerSample, 99.0));
+        result->setProperty("max", getPercentile(nsPerSample, 100.0));
+        return juce::var(result.get());
+    }
+
+    //==============================================================================
+    juce::var runBenchmark(const RunSettings& settings, const juce::AudioBuffer<float>& input)
+    {
+        DisruptionAudioProcessor processor;
+        const auto layout = juce::AudioChannelSet::canonicalChannelSet(settings.numChannels);
+
+        if (! processor.setBusesLayout({ { layout }, { layout } }))
+            return juce::var(juce::String("Unsupported channel count ") + juce::String(settings.numChannels));
+
+        processor.setRateAndBufferSizeDetails(settings.sampleRate, settings.blockSize);
+        processor.setOversamplingFactor(static_cast<DisruptionAudioProcessor::OversamplingFactor>(settings.oversamplingOrder));
+        processor.setLatencyMode(settings.latencyMode);
+        processor.setClippingMode(settings.clippingMode);
+        processor.setSIMDKernelEnabled(settings.simd);
+        processor.setDistortionValue(settings.drive);  // Before prepareToPlay so the knobs do not ramp
+        processor.setLevelValue(settings.level);
+        processor.prepareToPlay(settings.sampleRate, settings.blockSize);
+        processor.setTremoloOn(settings.tremolo);
+        processor.getLoadMonitor().setSummaryActive(settings.monitor);
+        processor.getSpectrumAnalyser().setActive(settings.analyser);
+
+        StageTimings timings;
+        processor.setStageTimings(settings.stageTimings ? &timings : nullptr);
+
+        juce::AudioBuffer<float> block(settings.numChannels, settings.blockSize);
+        juce::MidiBuffer midi;
+
+        std::vector<double> totalNs;
+        std::array<std::vector<double>, StageTimings::numStages> stageNs;
+
+        const int numBlocks = input.getNumSamples() / settings.blockSize;
+        const int warmUpBlocks = juce::jmin(numBlocks / 10, 64);
+        totalNs.reserve(static_cast<size_t>(numBlocks));
+
+        for (auto& stage : stageNs)
+            stage.reserve(static_cast<size_t>(numBlocks));
+
+        double processingSeconds = 0.0;
+        int measuredSamples = 0;
+
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            for (int channel = 0; channel < settings.numChannels; ++channel)
+                block.copyFrom(channel, 0, input, channel % 2, blockIndex * settings.blockSize, settings.blockSize);
+
+            timings.clear();
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(block, midi);
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            if (blockIndex < warmUpBlocks)
+                continue;
+
+            const double toNsPerSample = 1.e9 / settings.blockSize;
+            processingSeconds += seconds;
+            measuredSamples += settings.blockSize;
+            totalNs.push_back(seconds * toNsPerSample);
+
+            for (int stage = 0; stage < StageTimings::numStages; ++stage)
+                stageNs[static_cast<size_t>(stage)].push_back(timings.seconds[static_cast<size_t>(stage)] * toNsPerSample);
+        }
+
+        processor.setStageTimings(nullptr);
+        processor.getLoadMonitor().setSummaryActive(false);
+        processor.getSpectrumAnalyser().setActive(false);
+
+        const double audioSeconds = measuredSamples / settings.sampleRate;
+        const auto solver = processor.getSolverStatistics();
+
+        juce::DynamicObject::Ptr result = new juce::DynamicObject();
+        result->setProperty("input", settings.inputName);
+        result->setProperty("sampleRate", settings.sampleRate);
+        result->setProperty("blockSize", settings.blockSize);
+        result->setProperty("channels", settings.numChannels);
+        result->setProperty("drive", settings.drive);
+        result->setProperty("level", settings.level);
+        result->setProperty("tremolo", settings.tremolo);
+        result->setProperty("oversampling", 1 << settings.oversamplingOrder);
+        result->setProperty("latencyMode", getLatencyModeName(settings.latencyMode));
+        result->setProperty("latencySamples", processor.getLatencySamples());
+        result->setProperty("solver", CircuitModel::getClippingModeName(settings.clippingMode));
+        result->setProperty("simd", settings.simd);
+        result->setProperty("monitor", settings.monitor);
+        result->setProperty("analyser", settings.analyser);
+        result->setProperty("nsPerSample", measuredSamples > 0 ? processingSeconds * 1.e9 / measuredSamples : 0.0);
+        result->setProperty("realtimeFactor", processingSeconds > 0.0 ? audioSeconds / processingSeconds : 0.0);
+        result->setProperty("block", describeDistribution(totalNs));
+
+        if (settings.stageTimings)
+        {
+            juce::DynamicObject::Ptr stages = new juce::DynamicObject();
+
+            for (int stage = 0; stage < StageTimings::numStages; ++stage)
+                stages->setProperty(StageTimings::getStageName(stage), describeDistribution(stageNs[static_cast<size_t>(stage)]));
+
+            result->setProperty("stages", juce::var(stages.get()));
+        }
+
+        juce::DynamicObject::Ptr solverResult = new juce::DynamicObject();
+        solverResult->setProperty("averageIterations", solver.getAverageIterations());
+        solverResult->setProperty("maxIterations", solver.maxIterations);
+        solverResult->setProperty("nonConverged", static_cast<juce::int64>(solver.nonConverged));
+        result->setProperty("solverStatistics", juce::var(solverResult.get()));
+
+        return juce::var(result.get());
+    }
+
+    //==============================================================================
+    // Adds up the time the circuit spends in its clipping stage
+    struct ClippingStageTimer : public CircuitModel::StageListener
+    {
+        void circuitStageFinished(StageTimings::Stage stage) override
+        {
+            const auto now = juce::Time::getHighResolutionTicks();
+
+            if (stage == StageTimings::clipping)
+                seconds += juce::Time::highResolutionTicksToSeconds(now - startTicks);
+
+            startTicks = now;
+        }
+
+        juce::int64 startTicks = 0;
+        double seconds = 0.0;
+    };
+
+    // Bounds a solver has to stay within at every rate. The errors are a few times the worst
+    // measured over 44.1 to 352.8 kHz at drive 0.8, the iteration limits a few above the
+    // worst measured, and no solver may leave a sample unconverged
+    struct SolverLimits
+    {
+        float maxError;  // Volts, against the double precision reference
+        int maxIterations;
+    };
+
+    SolverLimits getSolverLimits(CircuitModel::ClippingMode mode)
+    {
+        switch (mode)
+        {
+            case CircuitModel::ClippingMode::newton:      return { 2.e-3f, 12 };
+            case CircuitModel::ClippingMode::halley:      return { 2.e-3f, 8 };
+            case CircuitModel::ClippingMode::wrightOmega: return { 2.e-4f, 0 };
+            case CircuitModel::ClippingMode::lookupTable: return { 5.e-5f, 0 };
+        }
+
+        return { 0.f, 0 };
+    }
+
+    juce::var runSolverComparison(const juce::StringArray& rates, double seconds, float drive, bool& passed)
+    {
+        passed = true;
+
+        constexpr int blockSize = 512;
+        juce::Array<juce::var> results;
+
+        for (const auto& rate : rates)
+        {
+            const double sampleRate = rate.getDoubleValue();
+            const auto input = makeSyntheticInput("guitar", sampleRate, seconds);
+            const int numChannels = input.getNumChannels();
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+
+            for (int mode = 0; mode < CircuitModel::numClippingModes; ++mode)
+            {
+                const auto clippingMode = static_cast<CircuitModel::ClippingMode>(mode);
+
+                CircuitModel circuit;
+                ClippingStageTimer timer;
+                circuit.prepare(sampleRate, 1, numChannels, blockSize);
+                circuit.setClippingMode(clippingMode);
+                circuit.setSIMDEnabled(false);  // Every solver through the same scalar loop
+                circuit.setDrive(drive);
+                circuit.setLevel(0.5f);
+                circuit.setStageListener(&timer);
+
+                const int numBlocks = input.getNumSamples() / blockSize;
+                const int warmUpBlocks = juce::jmin(numBlocks / 10, 64);
+                double measuredSeconds = 0.0;
+                juce::int64 measuredSamples = 0;
+
+                for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+                {
+                    for (int channel = 0; channel < numChannels; ++channel)
+                        buffer.copyFrom(channel, 0, input, channel, blockIndex * blockSize, blockSize);
+
+                    juce::dsp::AudioBlock<float> block(buffer);
+                    timer.seconds = 0.0;
+                    timer.startTicks = juce::Time::getHighResolutionTicks();
+                    circuit.process(block, nullptr, nullptr);
+
+                    if (blockIndex < warmUpBlocks)
+                        continue;
+
+                    measuredSeconds += timer.seconds;
+                    measuredSamples += blockSize * numChannels;
+                }
+
+                const auto& statistics = circuit.getSolverStatistics();
+                const float maxError = circuit.measureSolverError(clippingMode);
+                const auto limits = getSolverLimits(clippingMode);
+                const bool withinLimits = maxError <= limits.maxError && statistics.maxIterations <= limits.maxIterations
+                                       && statistics.nonConverged == 0;
+                passed = passed && withinLimits;
+
+                juce::DynamicObject::Ptr result = new juce::DynamicObject();
+                result->setProperty("circuitRate", sampleRate);
+                result->setProperty("solver", CircuitModel::getClippingModeName(clippingMode));
+                result->setProperty("maxError", maxError);
+                result->setProperty("maxErrorLimit", limits.maxError);
+                result->setProperty("nsPerSample", measuredSamples > 0 ? measuredSeconds * 1.e9 / static_cast<double>(measuredSamples) : 0.0);
+                result->setProperty("averageIterations", statistics.getAverageIterations());
+                result->setProperty("maxIterations", statistics.maxIterations);
+                result->setProperty("maxIterationsLimit", limits.maxIterations);
+                result->setProperty("nonConverged", static_cast<juce::int64>(statistics.nonConverged));
+                result->setProperty("passed", withinLimits);
+                results.add(juce::var(result.get()));
+            }
+        }
+
+        juce::DynamicObject::Ptr document = new juce::DynamicObject();
+        document->setProperty("benchmark", "CircuitModel solvers");
+        document->setProperty("drive", drive);
+        document->setProperty("passed", passed);
+        document->setProperty("cpu", juce::SystemStats::getCpuModel());
+        document->setProperty("results", juce::var(results));
+        return juce::var(document.get());
+    }
+
+    //==============================================================================
+    // The plugin's chorus settings
+    constexpr float chorusRate = 0.5f;
+    constexpr float chorusDepth = 0.2f;
+    constexpr float chorusFeedback = 0.2f;
+    constexpr float chorusMix = 0.3f;
+
+    // Both choruses behind one interface, so they run through the same loops
+    struct ChorusUnderTest
+    {
+        virtual ~ChorusUnderTest() = default;
+        virtual const char* getName() const = 0;
+        virtual void prepare(double sampleRate, int blockSize, int numChannels, float mix, float feedback) = 0;
+        virtual void process(juce::dsp::AudioBlock<float>& block) = 0;
+    };
+
+    struct JuceChorus : public ChorusUnderTest
+    {
+        const char* getName() const override { return "juce::dsp::Chorus"; }
+
+        void prepare(double sampleRate, int blockSize, int numChannels, float mix, float feedback) override
+        {
+            chorus.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) });
+            chorus.setRate(chorusRate);
+            chorus.setDepth(chorusDepth);
+            chorus.setCentreDelay(Chorus::centreDelayMs);
+            chorus.setFeedback(feedback);
+            chorus.setMix(mix);
+        }
+
+        void process(juce::dsp::AudioBlock<float>& block) override
+        {
+            chorus.process(juce::dsp::ProcessContextReplacing<float>(block));
+        }
+
+        juce::dsp::Chorus<float> chorus;
+    };
+
+    struct PluginChorus : public ChorusUnderTest
+    {
+        const char* getName() const override { return "Chorus"; }
+
+        void prepare(double sampleRate, int blockSize, int numChannels, float mix, float feedback) override
+        {
+            lfo.prepare(sampleRate, blockSize, numChannels);
+            lfo.setShape(LFO::Shape::sine);
+            lfo.setFrequency(chorusRate);
+            chorus.setDepth(chorusDepth);
+            chorus.setFeedback(feedback);
+            chorus.setMix(mix);
+            chorus.prepare(sampleRate, blockSize, numChannels);
+        }
+
+        // The LFO is rendered here, juce::dsp::Chorus runs its own inside process()
+        void process(juce::dsp::AudioBlock<float>& block) override
+        {
+            lfo.process(static_cast<int>(block.getNumSamples()));
+            chorus.process(block, lfo);
+        }
+
+        LFO lfo;
+        Chorus chorus;
+    };
+
+    double timeChorus(ChorusUnderTest& chorus, const juce::AudioBuffer<float>& input, double sampleRate, int blockSize)
+    {
+        const int numChannels = input.getNumChannels();
+        chorus.prepare(sampleRate, blockSize, numChannels, chorusMix, chorusFeedback);
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        const int numBlocks = input.getNumSamples() / blockSize;
+        const int warmUpBlocks = juce::jmin(numBlocks / 10, 64);
+        double measuredSeconds = 0.0;
+        juce::int64 measuredSamples = 0;
+
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                buffer.copyFrom(channel, 0, input, channel, blockIndex * blockSize, blockSize);
+
+            juce::dsp::AudioBlock<float> block(buffer);
+            const auto start = juce::Time::getHighResolutionTicks();
+            chorus.process(block);
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            if (blockIndex < warmUpBlocks)
+                continue;
+
+            measuredSeconds += seconds;
+            measuredSamples += blockSize * numChannels;
+        }
+
+        return measuredSamples > 0 ? measuredSeconds * 1.e9 / static_cast<double>(measuredSamples) : 0.0;
+    }
+
+    // Gain in dB of a fully wet sine without feedback, overall and over the worst 10 ms
+    // window. Ideal delay lines give 0 dB for both; interpolation loses treble, most at
+    // half sample delays, and the sweep passes through every fraction
+    std::pair<double, double> measureChorusGain(ChorusUnderTest& chorus, double sampleRate, double frequency, double seconds)
+    {
+        constexpr int blockSize = 512;
+        chorus.prepare(sampleRate, blockSize, 1, 1.f, 0.f);
+
+        juce::AudioBuffer<float> buffer(1, blockSize);
+        const int numBlocks = juce::roundToInt(sampleRate * seconds) / blockSize;
+        const int settleSamples = juce::roundToInt(sampleRate * 0.1);  // Delay line filled, mix settled
+        const int windowSamples = juce::roundToInt(sampleRate * 0.01);
+
+        double inputEnergy = 0.0, outputEnergy = 0.0;
+        double windowInput = 0.0, windowOutput = 0.0;
+        double worstGain = std::numeric_limits<double>::max();
+        int windowFill = 0;
+        juce::int64 sampleIndex = 0;
+
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            auto* samples = buffer.getWritePointer(0);
+            std::array<float, blockSize> input;
+
+            for (int n = 0; n < blockSize; ++n)
+            {
+                input[static_cast<size_t>(n)] = 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * static_cast<double>(sampleIndex + n) / sampleRate));
+                samples[n] = input[static_cast<size_t>(n)];
+            }
+
+            juce::dsp::AudioBlock<float> block(buffer);
+            chorus.process(block);
+
+            for (int n = 0; n < blockSize; ++n, ++sampleIndex)
+            {
+                if (sampleIndex < settleSamples)
+                    continue;
+
+                windowInput += juce::square(static_cast<double>(input[static_cast<size_t>(n)]));
+                windowOutput += juce::square(static_cast<double>(samples[n]));
+
+                if (++windowFill == windowSamples)
+                {
+                    inputEnergy += windowInput;
+                    outputEnergy += windowOutput;
+                    worstGain = juce::jmin(worstGain, windowOutput / windowInput);
+                    windowInput = windowOutput = 0.0;
+                    windowFill = 0;
+                }
+            }
+        }
+
+        if (inputEnergy <= 0.0)
+            return { 0.0, 0.0 };
+
+        return { 10.0 * std::log10(outputEnergy / inputEnergy), 10.0 * std::log10(worstGain) };
+    }
+
+    juce::var runChorusComparison(const juce::StringArray& rates, double seconds)
+    {
+        constexpr int blockSize = 512;
+        const double testFrequencies[] = { 1000.0, 5000.0, 10000.0 };
+        juce::Array<juce::var> results;
+
+        for (const auto& rate : rates)
+        {
+            const double sampleRate = rate.getDoubleValue();
+            const auto input = makeSyntheticInput("guitar", sampleRate, seconds);
+
+            JuceChorus juceChorus;
+            PluginChorus pluginChorus;
+
+            for (auto* chorus : { static_cast<ChorusUnderTest*>(&juceChorus), static_cast<ChorusUnderTest*>(&pluginChorus) })
+            {
+                juce::Array<juce::var> gains;
+
+                for (const auto frequency : testFrequencies)
+                {
+                    if (frequency >= sampleRate * 0.45)
+                        continue;
+
+                    const auto gain = measureChorusGain(*chorus, sampleRate, frequency, seconds);
+
+                    juce::DynamicObject::Ptr gainResult = new juce::DynamicObject();
+                    gainResult->setProperty("frequency", frequency);
+                    gainResult->setProperty("gainDb", gain.first);
+                    gainResult->setProperty("worstGainDb", gain.second);
+                    gains.add(juce::var(gainResult.get()));
+                }
+
+                juce::DynamicObject::Ptr result = new juce::DynamicObject();
+                result->setProperty("sampleRate", sampleRate);
+                result->setProperty("chorus", chorus->getName());
+                result->setProperty("nsPerSample", timeChorus(*chorus, input, sampleRate, blockSize));
+                result->setProperty("wetGain", juce::var(gains));
+                results.add(juce::var(result.get()));
+            }
+        }
+
+        juce::DynamicObject::Ptr document = new juce::DynamicObject();
+        document->setProperty("benchmark", "Chorus");
+        document->setProperty("rate", chorusRate);
+        document->setProperty("depth", chorusDepth);
+        document->setProperty("feedback", chorusFeedback);
+        document->setProperty("mix", chorusMix);
+        document->setProperty("cpu", juce::SystemStats::getCpuModel());
+        document->setProperty("results", juce::var(results));
+        return juce::var(document.get());
+    }
+
+    //==============================================================================
+    juce::var runPaintBenchmark(int paintsPerRun)
+    {
+        struct KnobUnderTest
+        {
+            const char* name;
+            int size;
+            juce::Colour thumbColour;
+        };
+
+        // As laid out by PedalComponent
+        const KnobUnderTest knobsUnderTest[] = { { "Drive", 85, juce::Colours::white },
+                                                 { "Tremolo", 64, juce::Colours::yellow } };
+        const float scales[] = { 1.f, 2.f };
+
+        PedalKnobLookAndFeel lookAndFeel;
+        juce::Array<juce::var> results;
+
+        for (const auto& knob : knobsUnderTest)
+        for (const auto scale : scales)
+        for (const bool cached : { false, true })
+        {
+            juce::Slider slider;
+            slider.setName(knob.name);
+            slider.setSliderStyle(juce::Slider::Rotary);
+            slider.setColour(juce::Slider::thumbColourId, knob.thumbColour);
+            const auto rotary = slider.getRotaryParameters();
+
+            lookAndFeel.setBodyCacheEnabled(cached);
+
+            juce::Image canvas(juce::Image::ARGB, juce::roundToInt(knob.size * scale), juce::roundToInt(knob.size * scale), true);
+            juce::Graphics g(canvas);
+            g.addTransform(juce::AffineTransform::scale(scale));
+
+            const auto paint = [&] (int index)
+            {
+                const float position = static_cast<float>(index % 101) / 100.f;
+                lookAndFeel.drawRotarySlider(g, 0, 0, knob.size, knob.size, position,
+                                             rotary.startAngleRadians, rotary.endAngleRadians, slider);
+            };
+
+            paint(0);  // Fills the cache, like the first paint of an editor
+
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (int i = 0; i < paintsPerRun; ++i)
+                paint(i);
+
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            juce::DynamicObject::Ptr result = new juce::DynamicObject();
+            result->setProperty("knob", knob.name);
+            result->setProperty("size", knob.size);
+            result->setProperty("scale", scale);
+            result->setProperty("bodyCache", cached);
+            result->setProperty("usPerPaint", paintsPerRun > 0 ? seconds * 1.e6 / paintsPerRun : 0.0);
+            results.add(juce::var(result.get()));
+        }
+
+        juce::DynamicObject::Ptr document = new juce::DynamicObject();
+        document->setProperty("benchmark", "PedalKnobLookAndFeel::drawRotarySlider");
+        document->setProperty("paints", paintsPerRun);
+        document->setProperty("cpu", juce::SystemStats::getCpuModel());
+        document->setProperty("results", juce::var(results));
+        return juce::var(document.get());
+    }
+
+    //==============================================================================
+    juce::var runEditorOpenBenchmark(int numEditors)
+    {
+        DisruptionAudioProcessor processor;
+        juce::Array<juce::var> openMs;
+        double laterSeconds = 0.0;
+
+        for (int i = 0; i < numEditors; ++i)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+            editor->createComponentSnapshot(editor->getLocalBounds());  // The first paint, as a host window would show it
+
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            openMs.add(seconds * 1000.0);
+
+            if (i > 0)
+                laterSeconds += seconds;
+        }
+
+        const auto& statistics = juce::SharedResourcePointer<PedalResources>()->getEditorOpenStatistics();
+
+        juce::DynamicObject::Ptr document = new juce::DynamicObject();
+        document->setProperty("benchmark", "PedalComponent open");
+        document->setProperty("editors", numEditors);
+        document->setProperty("firstMs", openMs.isEmpty() ? 0.0 : static_cast<double>(openMs.getFirst()));
+        document->setProperty("averageLaterMs", numEditors > 1 ? laterSeconds * 1000.0 / (numEditors - 1) : 0.0);
+        document->setProperty("reportedAverageMs", statistics.getAverageSeconds() * 1000.0);  // Measured by the editors themselves
+        document->setProperty("openMs", juce::var(openMs));
+        document->setProperty("cpu", juce::SystemStats::getCpuModel());
+        return juce::var(document.get());
+    }
+
+    //==============================================================================
+    juce::var runStressTest(double secondsPerLayout, bool& passed)
+    {
+        using Processor = DisruptionAudioProcessor;
+
+        static const char* const parameterIDs[] = { ParameterIDs::drive, ParameterIDs::level, ParameterIDs::tremoloRate,
+                                                    ParameterIDs::tremoloOn, ParameterIDs::tremoloDepth, ParameterIDs::tremoloShape,
+                                                    ParameterIDs::tremoloSpread,
+                                                    ParameterIDs::tempoSync, ParameterIDs::syncDivision, ParameterIDs::bypass,
+                                                    ParameterIDs::chorusDepth, ParameterIDs::chorusMix };
+        // Input and output channels, including the mono and stereo conversions
+        const std::pair<int, int> channelLayouts[] = { { 1, 1 }, { 1, 2 }, { 2, 1 }, { 2, 2 }, { 6, 6 }, { 8, 8 }, { 16, 16 } };
+        const int maxBlockSizes[] = { 32, 480, 2048 };
+        const double sampleRates[] = { 44100.0, 96000.0 };
+
+        Processor processor;
+        juce::Random random(4321);
+        juce::AudioBuffer<float> storage(Processor::maxChannels, 3 * 2048);
+        juce::MidiBuffer midi;
+
+        juce::int64 numBlocks = 0, numOversizeBlocks = 0, numChanges = 0, nonFinite = 0;
+        int numLayouts = 0;
+        AudioThreadGuard::resetViolations();
+
+        for (const auto sampleRate : sampleRates)
+        for (const auto maxBlockSize : maxBlockSizes)
+        for (const auto& [numInputs, numOutputs] : channelLayouts)
+        {
+            // A host changes the layout between releaseResources and prepareToPlay
+            processor.releaseResources();
+            const auto inputLayout = juce::AudioChannelSet::canonicalChannelSet(numInputs);
+            const auto outputLayout = juce::AudioChannelSet::canonicalChannelSet(numOutputs);
+
+            if (! processor.setBusesLayout({ { inputLayout }, { outputLayout } }))
+            {
+                passed = false;
+                return juce::var(juce::String("Layout rejected: ") + inputLayout.getDescription() + " to " + outputLayout.getDescription());
+            }
+
+            const int numChannels = juce::jmax(numInputs, numOutputs);  // Buffer channels, as a host passes them
+
+            processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+            processor.prepareToPlay(sampleRate, maxBlockSize);
+            ++numLayouts;
+
+            for (double elapsed = 0.0; elapsed < secondsPerLayout;)
+            {
+                // Hosts may pass any block size up to the prepared maximum, and some pass
+                // more than they announced, which the processor splits
+                const bool oversize = random.nextInt(8) == 0;
+                const int numSamples = oversize ? random.nextInt({ maxBlockSize + 1, 3 * maxBlockSize + 1 })
+                                                : random.nextInt({ 1, maxBlockSize + 1 });
+                numOversizeBlocks += oversize ? 1 : 0;
+                juce::AudioBuffer<float> block(storage.getArrayOfWritePointers(), numChannels, numSamples);
+
+                // Noise bursts between silences exercise the idle path as well
+                const bool silent = random.nextInt(4) == 0;
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int n = 0; n < numSamples; ++n)
+                        block.setSample(channel, n, silent ? 0.f : random.nextFloat() * 2.f - 1.f);
+
+                // Every few blocks change a parameter, a solver or a chain setting
+                if (random.nextInt(3) == 0)
+                {
+                    ++numChanges;
+
+                    switch (random.nextInt(5))
+                    {
+                        case 0: processor.setLatencyMode(static_cast<Processor::LatencyMode>(random.nextInt(3))); break;
+                        case 1: processor.setOversamplingFactor(static_cast<Processor::OversamplingFactor>(random.nextInt(4))); break;
+                        case 2: processor.setClippingMode(static_cast<Processor::ClippingMode>(random.nextInt(CircuitModel::numClippingModes))); break;
+                        case 3: processor.setSIMDKernelEnabled(random.nextBool()); break;
+
+                        default:
+                        {
+                            auto* parameter = processor.getParameters().getParameter(parameterIDs[random.nextInt(static_cast<int>(std::size(parameterIDs)))]);
+                            parameter->setValueNotifyingHost(random.nextFloat());
+                            break;
+                        }
+                    }
+                }
+
+                processor.processBlock(block, midi);
+                ++numBlocks;
+                elapsed += numSamples / sampleRate;
+
+                for (int channel = 0; channel < numOutputs; ++channel)
+                    for (int n = 0; n < numSamples; ++n)
+                        if (! std::isfinite(block.getSample(channel, n)))
+                            ++nonFinite;
+            }
+        }
+
+        processor.releaseResources();
+
+        const auto violations = static_cast<juce::int64>(AudioThreadGuard::getNumViolations());
+        passed = violations == 0 && nonFinite == 0;
+
+        juce::DynamicObject::Ptr result = new juce::DynamicObject();
+        result->setProperty("stress", "DisruptionAudioProcessor");
+        result->setProperty("audioThreadChecks", DISRUPTION_AUDIO_THREAD_CHECKS != 0);
+        result->setProperty("layouts", numLayouts);
+        result->setProperty("blocks", numBlocks);
+        result->setProperty("oversizeBlocks", numOversizeBlocks);
+        result->setProperty("changes", numChanges);
+        result->setProperty("audioThreadViolations", violations);
+        result->setProperty("nonFiniteSamples", nonFinite);
+        result->setProperty("passed", passed);
+        return juce::var(result.get());
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: DisruptionBenchmark [--rates=44100,48000,96000,192000] [--blocks=16,64,256,1024,4096] [--channels=2]\n"
+                     "                           [--drive=0.2,0.8] [--level=0.5] [--tremolo=off,on]\n"
+                     "                           [--oversampling=1] [--latency=low] [--solver=table] [--simd=on]\n"
+                     "                           [--monitor=off] [--analyser=off] [--stage-timings=on]\n"
+                     "                           [--seconds=2] [--inputs=guitar,sine,noise,silence] [--files=a.wav;b.flac]\n"
+                     "                           [--output=results.json]\n"
+                     "       DisruptionBenchmark --solvers [--rates=44100,88200,176400,352800] [--drive=0.8] [--seconds=2]\n"
+                     "       DisruptionBenchmark --chorus [--rates=44100,96000] [--seconds=2]\n"
+                     "       DisruptionBenchmark --paint [--paints=2000]\n"
+                     "       DisruptionBenchmark --editors [--count=20]\n"
+                     "       DisruptionBenchmark --stress [--seconds=2]" << std::endl;
+        return 0;
+    }
+
+    if (args.containsOption("--solvers"))
+    {
+        const double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 2.0;
+        const float drive = args.containsOption("--drive") ? args.getValueForOption("--drive").getFloatValue() : 0.8f;
+        bool passed = false;
+        std::cout << juce::JSON::toString(runSolverComparison(getList(args, "--rates", "44100,88200,176400,352800"), seconds, drive, passed)) << std::endl;
+        return passed ? 0 : 1;
+    }
+
+    if (args.containsOption("--chorus"))
+    {
+        const double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 2.0;
+        std::cout << juce::JSON::toString(runChorusComparison(getList(args, "--rates", "44100,96000"), seconds)) << std::endl;
+        return 0;
+    }
+
+    if (args.containsOption("--paint"))
+    {
+        const int paints = args.containsOption("--paints") ? args.getValueForOption("--paints").getIntValue() : 2000;
+        std::cout << juce::JSON::toString(runPaintBenchmark(paints)) << std::endl;
+        return 0;
+    }
+
+    if (args.containsOption("--editors"))
+    {
+        const int count = args.containsOption("--count") ? args.getValueForOption("--count").getIntValue() : 20;
+        std::cout << juce::JSON::toString(runEditorOpenBenchmark(juce::jmax(1, count))) << std::endl;
+        return 0;
+    }
+
+    if (args.containsOption("--stress"))
+    {
+        bool passed = false;
+        const double secondsPerLayout = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 2.0;
+        std::cout << juce::JSON::toString(runStressTest(secondsPerLayout, passed)) << std::endl;
+        return passed ? 0 : 1;
+    }
+
+    const auto rates = getList(args, "--rates", "44100,48000,96000,192000");
+    const auto blocks = getList(args, "--blocks", "16,64,256,1024,4096");
+    const auto channelCounts = getList(args, "--channels", "2");
+    const auto drives = getList(args, "--drive", "0.2,0.8");
+    const auto levels = getList(args, "--level", "0.5");
+    const auto tremolos = getList(args, "--tremolo", "off,on");
+    const auto oversampling = getList(args, "--oversampling", "1");
+    const auto latencyModes = getList(args, "--latency", "low");
+    const auto solvers = getList(args, "--solver", "table");
+    const auto simds = getList(args, "--simd", "on");
+    const auto monitors = getList(args, "--monitor", "off");
+    const auto analysers = getList(args, "--analyser", "off");
+    const bool stageTimings = args.getValueForOption("--stage-timings") != "off";
+    const auto inputs = getList(args, "--inputs", "guitar,sine,noise");
+    const auto files = getList(args, "--files", "");
+    const double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 2.0;
+
+    // File inputs are read once and played back unchanged at every rate under test
+    std::vector<std::pair<juce::String, juce::AudioBuffer<float>>> fileInputs;
+
+    for (const auto& path : files)
+    {
+        juce::AudioBuffer<float> buffer;
+        const juce::File file = juce::File::getCurrentWorkingDirectory().getChildFile(path);
+
+        if (! readFileInput(file, buffer))
+        {
+            std::cerr << "Could not read " << path << std::endl;
+            return 1;
+        }
+
+        fileInputs.emplace_back(file.getFileName(), std::move(buffer));
+    }
+
+    juce::Array<juce::var> results;
+
+    for (const auto& rate : rates)
+    {
+        const double sampleRate = rate.getDoubleValue();
+
+        std::vector<std::pair<juce::String, juce::AudioBuffer<float>>> runInputs;
+
+        for (const auto& input : inputs)
+            runInputs.emplace_back(input, makeSyntheticInput(input, sampleRate, seconds));
+
+        for (const auto& fileInput : fileInputs)
+            runInputs.push_back(fileInput);
+
+        for (const auto& input : runInputs)
+        for (const auto& blockSize : blocks)
+        for (const auto& channels : channelCounts)
+        for (const auto& drive : drives)
+        for (const auto& level : levels)
+        for (const auto& tremolo : tremolos)
+        for (const auto& factor : oversampling)
+        for (const auto& latency : latencyModes)
+        for (const auto& solver : solvers)
+        for (const auto& simd : simds)
+        for (const auto& monitor : monitors)
+        for (const auto& analyser : analysers)
+        {
+            RunSettings settings;
+            settings.inputName = input.first;
+            settings.sampleRate = sampleRate;
+            settings.blockSize = blockSize.getIntValue();
+            settings.numChannels = juce::jlimit(1, DisruptionAudioProcessor::maxChannels, channels.getIntValue());
+            settings.drive = drive.getFloatValue();
+            settings.level = level.getFloatValue();
+            settings.tremolo = tremolo == "on";
+            settings.oversamplingOrder = juce::jlimit(0, 3, juce::roundToInt(std::log2(juce::jmax(1, factor.getIntValue()))));
+            settings.latencyMode = getLatencyMode(latency);
+            settings.clippingMode = CircuitModel::getClippingModeForName(solver);
+            settings.simd = simd != "off";
+            settings.monitor = monitor == "on";
+            settings.analyser = analyser == "on";
+            settings.stageTimings = stageTimings;
+
+            results.add(runBenchmark(settings, input.second));
+            std::cerr << "." << std::flush;
+        }
+    }
+
+    std::cerr << std::endl;
+
+    juce::DynamicObject::Ptr document = new juce::DynamicObject();
+    document->setProperty("benchmark", "DisruptionAudioProcessor");
+    document->setProperty("version", 1);
+    document->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+    document->setProperty("host", juce::SystemStats::getComputerName());
+    document->setProperty("cpu", juce::SystemStats::getCpuModel());
+    document->setProperty("results", juce::var(results));
+
+    const auto json = juce::JSON::toString(juce::var(document.get()));
+
+    if (args.containsOption("--output"))
+    {
+        const auto outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+        if (! outputFile.replaceWithText(json))
+        {
+            std::cerr << "Could not write " << outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,409 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../source/PluginProcessor.h"
+
+//==============================================================================
+// Batch renderer for DisruptionAudioProcessor.
+//
+// Streams every input file through the processor once per setting and writes one output
+// file per pair. Audio is read, processed and written block by block, so memory use does
+// not depend on file length. Renders run in parallel on a thread pool, each worker owns
+// its own processor instance.
+//
+//   DisruptionRender --files=di/;take2.flac [--output-dir=rendered] [--drive=0.2,0.5,0.8]
+//                    [--level=0.5] [--tremolo=off,on] [--rate=2] [--oversampling=1,4] [--latency=low,high]
+//                    [--solver=table] [--presets=presets.json] [--threads=8]
+//                    [--block=512] [--format=wav|flac] [--bits=24]
+//
+// Without --presets every combination of the listed values is rendered. A preset file is
+// a JSON object or array of objects with any of: name, drive, level, rate, tremolo,
+// oversampling, latency, solver.
+
+namespace
+{
+    struct RenderSettings
+    {
+        juce::String name;  // Appended to the output file names
+        float drive = 0.5f;
+        float level = 0.5f;
+        float tremoloRate = 2.f;
+        bool tremolo = false;
+        int oversamplingOrder = 0;
+        DisruptionAudioProcessor::LatencyMode latencyMode = DisruptionAudioProcessor::LatencyMode::lowLatency;
+        DisruptionAudioProcessor::ClippingMode clippingMode = DisruptionAudioProcessor::ClippingMode::lookupTable;
+    };
+
+    struct RenderJob
+    {
+        juce::File input;
+        juce::File output;
+        const RenderSettings* settings = nullptr;
+
+        juce::String error;          // Empty if the render succeeded
+        juce::int64 numFrames = 0;   // Frames written
+        double sampleRate = 0.0;
+    };
+
+    //==============================================================================
+    juce::StringArray getList(const juce::ArgumentList& args, const juce::String& option, const juce::String& defaultValue)
+    {
+        const auto value = args.containsOption(option) ? args.getValueForOption(option) : defaultValue;
+        auto list = juce::StringArray::fromTokens(value, ",;", "");
+        list.trim();
+        list.removeEmptyStrings();
+        return list;
+    }
+
+    int getOversamplingOrder(int factor)
+    {
+        return juce::jlimit(0, 3, juce::roundToInt(std::log2(juce::jmax(1, factor))));
+    }
+
+    DisruptionAudioProcessor::LatencyMode getLatencyMode(const juce::String& name)
+    {
+        if (name == "zero")
+            return DisruptionAudioProcessor::LatencyMode::zeroLatency;
+
+        return name == "high" ? DisruptionAudioProcessor::LatencyMode::highQuality
+                              : DisruptionAudioProcessor::LatencyMode::lowLatency;
+    }
+
+    juce::String makeSettingsName(const RenderSettings& settings)
+    {
+        auto name = "drive" + juce::String(settings.drive, 2) + "_level" + juce::String(settings.level, 2);
+
+        if (settings.tremolo)
+            name << "_trem" << juce::String(settings.tremoloRate, 2);
+
+        if (settings.oversamplingOrder > 0)
+            name << "_x" << (1 << settings.oversamplingOrder);
+
+        if (settings.latencyMode == DisruptionAudioProcessor::LatencyMode::zeroLatency)
+            name << "_zero";
+        else if (settings.latencyMode == DisruptionAudioProcessor::LatencyMode::highQuality)
+            name << "_hq";
+
+        if (settings.clippingMode != DisruptionAudioProcessor::ClippingMode::lookupTable)
+            name << "_" << CircuitModel::getClippingModeName(settings.clippingMode);
+
+        return name;
+    }
+
+    bool readPresets(const juce::File& file, const RenderSettings& defaults, std::vector<RenderSettings>& presets)
+    {
+        const auto json = juce::JSON::parse(file);
+        juce::Array<juce::var> entries;
+
+        if (auto* list = json.getArray())
+            entries = *list;
+        else if (json.isObject())
+            entries.add(json);
+        else
+            return false;
+
+        for (const auto& entry : entries)
+        {
+            RenderSettings settings = defaults;
+            settings.drive = static_cast<float>(entry.getProperty("drive", settings.drive));
+            settings.level = static_cast<float>(entry.getProperty("level", settings.level));
+            settings.tremoloRate = static_cast<float>(entry.getProperty("rate", settings.tremoloRate));
+            settings.tremolo = static_cast<bool>(entry.getProperty("tremolo", settings.tremolo));
+            settings.oversamplingOrder = getOversamplingOrder(static_cast<int>(entry.getProperty("oversampling", 1 << settings.oversamplingOrder)));
+            settings.latencyMode = getLatencyMode(entry.getProperty("latency", "low").toString());
+            settings.clippingMode = CircuitModel::getClippingModeForName(entry.getProperty("solver", "table").toString());
+            settings.name = entry.getProperty("name", makeSettingsName(settings)).toString();
+            presets.push_back(settings);
+        }
+
+        return ! presets.empty();
+    }
+
+    //==============================================================================
+    // Pulls jobs off the shared list until none are left
+    class RenderWorker : public juce::ThreadPoolJob
+    {
+    public:
+        RenderWorker(std::vector<RenderJob>& jobsToRun, std::atomic<size_t>& nextJobIndex,
+                     int blockSizeToUse, int bitsPerSampleToUse,
+                     std::unique_ptr<DisruptionAudioProcessor> processorToUse)
+            : juce::ThreadPoolJob("Render worker"),
+              jobs(jobsToRun), nextJob(nextJobIndex),
+              blockSize(blockSizeToUse), bitsPerSample(bitsPerSampleToUse),
+              processor(std::move(processorToUse)),
+              buffer(2, blockSizeToUse)
+        {
+            formatManager.registerBasicFormats();
+        }
+
+        JobStatus runJob() override
+        {
+            for (auto index = nextJob++; index < jobs.size() && ! shouldExit(); index = nextJob++)
+            {
+                render(jobs[index]);
+                std::cerr << (jobs[index].error.isEmpty() ? "." : "x") << std::flush;
+            }
+
+            return jobHasFinished;
+        }
+
+    private:
+        void render(RenderJob& job)
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(job.input));
+
+            if (reader == nullptr)
+            {
+                job.error = "Could not read " + job.input.getFullPathName();
+                return;
+            }
+
+            auto* format = formatManager.findFormatForFileExtension(job.output.getFileExtension());
+            const int numChannels = juce::jlimit(1, DisruptionAudioProcessor::maxChannels, static_cast<int>(reader->numChannels));  // Further channels are ignored
+
+            // Mono files run through the stereo pedal as before, stems and beds keep their layout
+            const int numProcessed = juce::jmax(2, numChannels);
+            const auto layout = juce::AudioChannelSet::canonicalChannelSet(numProcessed);
+
+            job.output.deleteFile();
+            auto stream = std::make_unique<juce::FileOutputStream>(job.output);
+            std::unique_ptr<juce::AudioFormatWriter> writer;
+
+            if (format != nullptr && stream->openedOk())
+                writer.reset(format->createWriterFor(stream.get(), reader->sampleRate, static_cast<unsigned int>(numChannels),
+                                                     bitsPerSample, {}, 0));
+
+            if (writer == nullptr)
+            {
+                job.error = "Could not write " + job.output.getFullPathName();
+                return;
+            }
+
+            stream.release();  // Now owned by the writer
+
+            // Knob values are set before prepareToPlay, so the render starts without a ramp
+            const auto& settings = *job.settings;
+            processor->setDistortionValue(settings.drive);
+            processor->setLevelValue(settings.level);
+            processor->setTremoloRate(settings.tremoloRate);
+            processor->setTremoloOn(settings.tremolo);
+            processor->setOversamplingFactor(static_cast<DisruptionAudioProcessor::OversamplingFactor>(settings.oversamplingOrder));
+            processor->setLatencyMode(settings.latencyMode);
+            processor->setClippingMode(settings.clippingMode);
+
+            if (! processor->setBusesLayout({ { layout }, { layout } }))
+            {
+                job.error = "Unsupported channel layout in " + job.input.getFullPathName();
+                return;
+            }
+
+            processor->setRateAndBufferSizeDetails(reader->sampleRate, blockSize);
+            processor->prepareToPlay(reader->sampleRate, blockSize);
+
+            // The processor output is shifted back by its latency and the input padded with
+            // silence to flush it, so the output lines up with the input sample for sample
+            const int latency = processor->getLatencySamples();
+            const auto length = reader->lengthInSamples;
+            juce::int64 readPosition = 0;
+
+            while (job.numFrames < length)
+            {
+                const int numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), length + latency - readPosition));
+                buffer.setSize(numProcessed, numSamples, false, false, true);
+                reader->read(&buffer, 0, numSamples, readPosition, true, true);  // Zeros past the end, mono to both channels
+
+                processor->processBlock(buffer, midi);
+
+                const int skip = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(numSamples), latency - readPosition));
+                const int numToWrite = static_cast<int>(juce::jmin(static_cast<juce::int64>(numSamples - skip), length - job.numFrames));
+
+                if (numToWrite > 0 && ! writer->writeFromAudioSampleBuffer(buffer, skip, numToWrite))
+                {
+                    job.error = "Write failed for " + job.output.getFullPathName();
+                    return;
+                }
+
+                readPosition += numSamples;
+                job.numFrames += juce::jmax(0, numToWrite);
+            }
+
+            job.sampleRate = reader->sampleRate;
+        }
+
+        std::vector<RenderJob>& jobs;
+        std::atomic<size_t>& nextJob;
+        const int blockSize;
+        const int bitsPerSample;
+
+        std::unique_ptr<DisruptionAudioProcessor> processor;
+        juce::AudioFormatManager formatManager;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+
+        JUCE_DECLARE_NON_COPYABLE(RenderWorker)
+    };
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h") || ! args.containsOption("--files"))
+    {
+        std::cout << "Usage: DisruptionRender --files=di/;take2.flac [--output-dir=rendered]\n"
+                     "                        [--drive=0.2,0.5,0.8] [--level=0.5] [--tremolo=off,on] [--rate=2]\n"
+                     "                        [--oversampling=1,4] [--latency=low] [--solver=table] [--presets=presets.json]\n"
+                     "                        [--threads=8] [--block=512] [--format=wav|flac] [--bits=24]" << std::endl;
+        return args.containsOption("--help|-h") ? 0 : 1;
+    }
+
+    const auto workingDirectory = juce::File::getCurrentWorkingDirectory();
+
+    // Inputs are files or folders, folders are searched recursively
+    juce::Array<juce::File> inputs;
+
+    for (const auto& path : getList(args, "--files", ""))
+    {
+        const auto file = workingDirectory.getChildFile(path);
+
+        if (file.isDirectory())
+            inputs.addArray(file.findChildFiles(juce::File::findFiles, true, "*.wav;*.flac"));
+        else if (file.existsAsFile())
+            inputs.add(file);
+        else
+            std::cerr << "Skipping missing input " << path << std::endl;
+    }
+
+    if (inputs.isEmpty())
+    {
+        std::cerr << "No input files" << std::endl;
+        return 1;
+    }
+
+    // Settings to render, either presets or every combination of the swept values
+    std::vector<RenderSettings> settingsList;
+    RenderSettings defaults;
+    defaults.tremoloRate = args.containsOption("--rate") ? args.getValueForOption("--rate").getFloatValue() : defaults.tremoloRate;
+
+    if (args.containsOption("--presets"))
+    {
+        const auto presetFile = workingDirectory.getChildFile(args.getValueForOption("--presets"));
+
+        if (! readPresets(presetFile, defaults, settingsList))
+        {
+            std::cerr << "Could not read presets from " << presetFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        for (const auto& drive : getList(args, "--drive", "0.5"))
+        for (const auto& level : getList(args, "--level", "0.5"))
+        for (const auto& tremolo : getList(args, "--tremolo", "off"))
+        for (const auto& factor : getList(args, "--oversampling", "1"))
+        for (const auto& latency : getList(args, "--latency", "low"))
+        for (const auto& solver : getList(args, "--solver", "table"))
+        {
+            RenderSettings settings = defaults;
+            settings.drive = juce::jlimit(0.f, 1.f, drive.getFloatValue());
+            settings.level = juce::jlimit(0.f, 1.f, level.getFloatValue());
+            settings.tremolo = tremolo == "on";
+            settings.oversamplingOrder = getOversamplingOrder(factor.getIntValue());
+            settings.latencyMode = getLatencyMode(latency);
+            settings.clippingMode = CircuitModel::getClippingModeForName(solver);
+            settings.name = makeSettingsName(settings);
+            settingsList.push_back(settings);
+        }
+    }
+
+    const auto outputDirectory = workingDirectory.getChildFile(args.containsOption("--output-dir") ? args.getValueForOption("--output-dir") : "rendered");
+
+    if (! outputDirectory.createDirectory())
+    {
+        std::cerr << "Could not create " << outputDirectory.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    const auto format = args.getValueForOption("--format").toLowerCase();
+    const int bitsPerSample = args.containsOption("--bits") ? args.getValueForOption("--bits").getIntValue() : 24;
+    const int blockSize = juce::jmax(16, args.containsOption("--block") ? args.getValueForOption("--block").getIntValue() : 512);
+
+    std::vector<RenderJob> jobs;
+
+    for (const auto& input : inputs)
+    {
+        // Outputs keep the input format unless one is given
+        const auto extension = format.isNotEmpty() ? "." + format : input.getFileExtension().toLowerCase();
+
+        for (const auto& settings : settingsList)
+        {
+            RenderJob job;
+            job.input = input;
+            job.output = outputDirectory.getChildFile(input.getFileNameWithoutExtension() + "_" + settings.name + extension);
+            job.settings = &settings;
+            jobs.push_back(job);
+        }
+    }
+
+    // One processor per worker, created here because the parameter state expects the
+    // message thread during construction
+    const int numThreads = juce::jlimit(1, static_cast<int>(jobs.size()),
+                                        args.containsOption("--threads") ? args.getValueForOption("--threads").getIntValue()
+                                                                         : juce::SystemStats::getNumCpus());
+    std::atomic<size_t> nextJob { 0 };
+    std::vector<std::unique_ptr<RenderWorker>> workers;
+
+    for (int i = 0; i < numThreads; ++i)
+        workers.push_back(std::make_unique<RenderWorker>(jobs, nextJob, blockSize, bitsPerSample,
+                                                         std::make_unique<DisruptionAudioProcessor>()));
+
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    {
+        juce::ThreadPool pool(numThreads);
+
+        for (auto& worker : workers)
+            pool.addJob(worker.get(), false);
+
+        for (auto& worker : workers)
+            pool.waitForJobToFinish(worker.get(), -1);
+    }
+
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    std::cerr << std::endl;
+
+    // Throughput over the successful renders
+    int numRendered = 0;
+    juce::int64 numFrames = 0;
+    double audioSeconds = 0.0;
+
+    for (const auto& job : jobs)
+    {
+        if (job.error.isNotEmpty())
+        {
+            std::cerr << job.error << std::endl;
+            continue;
+        }
+
+        ++numRendered;
+        numFrames += job.numFrames;
+        audioSeconds += job.numFrames / job.sampleRate;
+    }
+
+    juce::DynamicObject::Ptr report = new juce::DynamicObject();
+    report->setProperty("inputs", inputs.size());
+    report->setProperty("settings", static_cast<int>(settingsList.size()));
+    report->setProperty("rendered", numRendered);
+    report->setProperty("failed", static_cast<int>(jobs.size()) - numRendered);
+    report->setProperty("threads", numThreads);
+    report->setProperty("wallSeconds", wallSeconds);
+    report->setProperty("audioSeconds", audioSeconds);
+    report->setProperty("filesPerSecond", wallSeconds > 0.0 ? numRendered / wallSeconds : 0.0);
+    report->setProperty("samplesPerSecond", wallSeconds > 0.0 ? static_cast<double>(numFrames) / wallSeconds : 0.0);
+    report->setProperty("realtimeFactor", wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0);
+    report->setProperty("outputDirectory", outputDirectory.getFullPathName());
+
+    std::cout << juce::JSON::toString(juce::var(report.get())) << std::endl;
+    return numRendered == static_cast<int>(jobs.size()) ? 0 : 1;
+}